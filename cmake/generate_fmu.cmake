@@ -6,7 +6,9 @@ set(_fmu4cpp_root "${_fmu4cpp_root}" CACHE INTERNAL "")
 
 function(generateFMU modelIdentifier)
 
-    set(options WITH_SOURCES)
+    # UNCHECKED: skip the per-call validation of value references and FMI state in Release builds,
+    # for importers that are known to follow the model description. Debug builds keep the checks.
+    set(options WITH_SOURCES UNCHECKED)
     set(oneValueArgs RESOURCE_FOLDER DOC_FOLDER DESTINATION)
     set(multiValueArgs FMI_VERSIONS SOURCES INCLUDE_DIRS LINK_TARGETS COMPILE_DEFINITIONS)
     cmake_parse_arguments(FMU "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
@@ -40,6 +42,11 @@ function(generateFMU modelIdentifier)
     endif ()
 
 
+    set(objectSuffix "")
+    if (FMU_UNCHECKED)
+        set(objectSuffix "_unchecked")
+    endif ()
+
     foreach (fmiVersion IN LISTS FMU_FMI_VERSIONS)
 
         _getTargetPlatform(${fmiVersion})
@@ -61,18 +68,18 @@ function(generateFMU modelIdentifier)
         set(VERSIONS_DEFS "")
         if (fmiVersion STREQUAL "fmi2")
             list(APPEND VERSION_DEFS "FMI2")
-            target_compile_definitions(fmu4cpp_fmi2 PUBLIC "FMI2")
-            list(APPEND VERSION_OBJECTS "$<TARGET_OBJECTS:fmu4cpp_fmi2>")
+            target_compile_definitions(fmu4cpp_fmi2${objectSuffix} PUBLIC "FMI2")
+            list(APPEND VERSION_OBJECTS "$<TARGET_OBJECTS:fmu4cpp_fmi2${objectSuffix}>")
         elseif (fmiVersion STREQUAL "fmi3")
             list(APPEND VERSION_DEFS "FMI3")
-            target_compile_definitions(fmu4cpp_fmi3 PUBLIC "FMI3")
-            list(APPEND VERSION_OBJECTS "$<TARGET_OBJECTS:fmu4cpp_fmi3>")
+            target_compile_definitions(fmu4cpp_fmi3${objectSuffix} PUBLIC "FMI3")
+            list(APPEND VERSION_OBJECTS "$<TARGET_OBJECTS:fmu4cpp_fmi3${objectSuffix}>")
         else ()
             message(FATAL_ERROR "Unknown FMI version: ${fmiVersion}. Supported versions are 'fmi2' and 'fmi3'.")
         endif ()
 
         add_library(${versionTarget} SHARED
-                "$<TARGET_OBJECTS:fmu4cpp_base>"
+                "$<TARGET_OBJECTS:fmu4cpp_base${objectSuffix}>"
                 "${FMU_SOURCES}"
                 "${VERSION_OBJECTS}"
         )
@@ -8,8 +8,12 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <queue>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -17,6 +21,7 @@
 #include "fmu_variable.hpp"
 #include "logger.hpp"
 #include "model_info.hpp"
+#include "reflect.hpp"
 #include "status.hpp"
 
 
@@ -82,6 +87,45 @@ namespace fmu4cpp {
 
     }// namespace state
 
+    namespace bound {
+
+        // The model type an accessor bound at compile time is invoked on:
+        // member functions of the model, or free functions taking the model as first argument.
+        template<typename F>
+        struct model_of;
+
+        template<typename R, typename M>
+        struct model_of<R (M::*)() const> {
+            using type = M;
+        };
+
+        template<typename R, typename M>
+        struct model_of<R (M::*)()> {
+            using type = M;
+        };
+
+        template<typename R, typename M, typename A>
+        struct model_of<R (M::*)(A)> {
+            using type = M;
+        };
+
+        template<typename R, typename M>
+        struct model_of<R (*)(const M &)> {
+            using type = M;
+        };
+
+        template<typename R, typename M>
+        struct model_of<R (*)(M &)> {
+            using type = M;
+        };
+
+        template<typename R, typename M, typename A>
+        struct model_of<R (*)(M &, A)> {
+            using type = M;
+        };
+
+    }// namespace bound
+
     struct fmu_data {
         logger *fmiLogger{nullptr};
         std::string instanceName{};
@@ -92,6 +136,71 @@ namespace fmu4cpp {
     class fmu_base {
 
     public:
+        enum class value_type : uint8_t {
+            INTEGER,
+            REAL,
+            BOOLEAN,
+            STRING,
+            BINARY,
+            FLOAT32,
+            INT8,
+            UINT8,
+            INT16,
+            UINT16,
+            UINT32,
+            INT64,
+            UINT64
+        };
+
+        // See substep_fmu_base
+        enum class internal_step {
+            FIXED,  // every communication step is a whole number of internal steps
+            MAXIMUM,// communication steps are split into the fewest equal sub-steps no longer than the internal step
+        };
+
+        // The mode the instance is in, which decides which variables the importer may set.
+        enum class fmu_mode : uint8_t {
+            INSTANTIATED = 1 << 0,
+            INITIALISATION = 1 << 1,
+            STEP = 1 << 2
+        };
+
+        // Consecutive value references of variables of one type, see find_subtree
+        struct vr_range {
+            value_type type;
+            unsigned int first;
+            size_t size;
+        };
+
+        // A list of value references that has been resolved and validated once,
+        // so that repeated transfers of the same variables skip the per-call lookups.
+        class access_plan {
+
+        public:
+            [[nodiscard]] value_type type() const {
+                return type_;
+            }
+
+            [[nodiscard]] size_t size() const {
+                return size_;
+            }
+
+        private:
+            friend class fmu_base;
+
+            struct run {
+                uint32_t index;// index of the first variable in the vector holding variables of this type
+                uint32_t count;
+                bool direct;// consecutive memory without onChange hooks, copied in one go
+            };
+
+            value_type type_{value_type::REAL};
+            size_t size_{0};
+            uint8_t settable_{0xFF};// modes in which all the variables of the plan may be set
+            std::vector<run> runs_;
+            std::vector<unsigned int> vrs_;
+        };
+
         explicit fmu_base(fmu_data data);
 
         fmu_base(const fmu_base &) = delete;
@@ -115,12 +224,43 @@ namespace fmu4cpp {
         [[nodiscard]] std::optional<StringVariable> get_string_variable(const std::string &name) const;
         [[nodiscard]] std::optional<BinaryVariable> get_binary_variable(const std::string &name) const;
 
+        // Non-owning lookups by name. The returned pointers are invalidated by registering more variables.
+        [[nodiscard]] const IntVariable *find_int_variable(std::string_view name) const;
+        [[nodiscard]] const RealVariable *find_real_variable(std::string_view name) const;
+        [[nodiscard]] const BoolVariable *find_bool_variable(std::string_view name) const;
+        [[nodiscard]] const StringVariable *find_string_variable(std::string_view name) const;
+        [[nodiscard]] const BinaryVariable *find_binary_variable(std::string_view name) const;
+
+        // The variables under a structured name, e.g. "pump[3]" covers pump[3].motor.torque and pump[3][0], but not pump[30].
+        // Returned as runs of consecutive value references per type, in value reference order,
+        // so variables registered together come back as a single run that can be passed to get_real etc.
+        [[nodiscard]] std::vector<vr_range> find_subtree(std::string_view prefix) const;
+
+        // Typed handles for in-process access, resolved once. Throws if no variable of that type has the given name.
+        template<typename T>
+        [[nodiscard]] VarHandle<T> handle(std::string_view name);
+
+        // For a variable returned by one of the register functions, e.g. handle(register_real("x", &x_))
+        template<typename V>
+        [[nodiscard]] VarHandle<typename V::value_type> handle(const V &variable) {
+            using T = typename V::value_type;
+            return {*this, variables_of<T>(), access_index(variable.value_reference(), type_of<T>())};
+        }
+
         void enter_initialisation_mode(double start, std::optional<double> stop, std::optional<double> tolerance);
         virtual void exit_initialisation_mode();
         bool step(double currentTime, double dt);
         virtual void terminate();
         virtual void reset();
 
+        // Used by the FMI functions in place of exit_initialisation_mode() and reset(), so that the mode is tracked.
+        void finish_initialisation();
+        void reset_instance();
+
+        [[nodiscard]] fmu_mode mode() const {
+            return mode_;
+        }
+
         void get_integer(const unsigned int vr[], size_t nvr, int value[]) const;
         void get_real(const unsigned int vr[], size_t nvr, double value[]) const;
 
@@ -144,6 +284,35 @@ namespace fmu4cpp {
         void set_string(const unsigned int vr[], size_t nvr, const char *const value[]);
         void set_binary(const unsigned int vr[], size_t nvr, const size_t valueSizes[], const uint8_t *const value[]);
 
+        //fmi3, where the value reference of an array variable stands for all of its elements.
+        // nValues is the total number of values, and must cover the arrays.
+        void get_integer(const unsigned int vr[], size_t nvr, int value[], size_t nValues) const;
+        void get_real(const unsigned int vr[], size_t nvr, double value[], size_t nValues) const;
+        void get_boolean(const unsigned int vr[], size_t nvr, bool value[], size_t nValues) const;
+
+        void set_integer(const unsigned int vr[], size_t nvr, const int value[], size_t nValues);
+        void set_real(const unsigned int vr[], size_t nvr, const double value[], size_t nValues);
+        void set_boolean(const unsigned int vr[], size_t nvr, const bool value[], size_t nValues);
+
+        //fmi3 Float32, Int8, UInt8, Int16, UInt16, UInt32, Int64 and UInt64, copied at their native width.
+        template<typename T>
+        void get_numeric(const unsigned int vr[], size_t nvr, T value[], size_t nValues) const;
+        template<typename T>
+        void set_numeric(const unsigned int vr[], size_t nvr, const T value[], size_t nValues);
+
+        // Integer, Real and Boolean only. Throws if the value references are invalid or of mixed types.
+        [[nodiscard]] access_plan prepare_access(const unsigned int vr[], size_t nvr) const;
+
+        void get_integer(const access_plan &plan, int value[]) const;
+        void get_real(const access_plan &plan, double value[]) const;
+        void get_boolean(const access_plan &plan, int value[]) const;
+        void get_boolean(const access_plan &plan, bool value[]) const;
+
+        void set_integer(const access_plan &plan, const int value[]);
+        void set_real(const access_plan &plan, const double value[]);
+        void set_boolean(const access_plan &plan, const int value[]);
+        void set_boolean(const access_plan &plan, const bool value[]);
+
         [[nodiscard]] std::string guid() const;
         [[nodiscard]] std::string make_description() const;
 
@@ -159,7 +328,71 @@ namespace fmu4cpp {
 
         [[nodiscard]] std::vector<unsigned int> get_value_refs() const;
 
-        virtual ~fmu_base() = default;
+        // Output change tracking. Enabled by the first call to either of the functions below,
+        // after which outputs are compared against their previous values whenever a step completes.
+
+        // Appends the value references of outputs that changed after `since` to `vrs`, and returns the token
+        // to pass next time. Use 0 on the first call to receive all outputs.
+        uint64_t changed_outputs(uint64_t since, std::vector<unsigned int> &vrs);
+        // Invoked after each step with the outputs that changed during that step.
+        void set_outputs_changed_callback(std::function<void(const unsigned int vr[], size_t nvr)> callback);
+
+        // FMI3 intermediate updates, see publish_intermediate and request_early_return. The callback is given the time
+        // the published outputs belong to and whether the step may end there, and returns the time the importer wants
+        // the step to end at, if any. Without earlyReturnAllowed, every step runs to its end.
+        using intermediate_update_callback = std::function<std::optional<double>(double time, bool canReturnEarly)>;
+        void set_intermediate_update(intermediate_update_callback callback, bool earlyReturnAllowed,
+                                     std::vector<unsigned int> requiredVariables = {});
+
+        // The time the last step ended at, if it returned before the end of the communication step.
+        [[nodiscard]] std::optional<double> early_return() const {
+            return earlyReturn_;
+        }
+
+        // FMI3 Co-Simulation event mode. When used, a step that passes a time event ends there if early returns are
+        // allowed, and the importer handles the event through update_discrete_states. Otherwise time events are
+        // handled within step(), as they are reached.
+        void set_event_mode_used(bool used) {
+            eventModeUsed_ = used;
+        }
+
+        // Whether a time event is due at the current time.
+        [[nodiscard]] bool event_pending() const;
+
+        struct discrete_update {
+            bool needsUpdate{false};// another iteration is needed before leaving event mode
+            std::optional<double> nextEventTime;
+        };
+        // One iteration of event handling at the current time: drops the time events that are due and calls do_discrete_update.
+        discrete_update update_discrete_states();
+
+        // Model Exchange, offered by models that register continuous states, see register_continuous_states.
+        [[nodiscard]] bool provides_model_exchange() const {
+            return nStates_ > 0;
+        }
+
+        [[nodiscard]] size_t number_of_continuous_states() const {
+            return nStates_;
+        }
+
+        // Used by the FMI functions for instances created for Model Exchange. From then on, values are only read
+        // after update_derivatives has seen the latest time, states and inputs.
+        void enable_model_exchange();
+        void set_time(double time);
+
+        // nx must be the number of continuous states
+        void get_continuous_states(double x[], size_t nx) const;
+        void set_continuous_states(const double x[], size_t nx);
+        void get_derivatives(double dx[], size_t nx) const;
+
+        // Opt-in: publishes time and the Integer, Real and Boolean outputs at the end of every step,
+        // so that other threads can read them while the next step is in progress. Variables registered later are not included.
+        void enable_output_snapshot();
+        // Safe to call from any thread, never blocks the stepping thread. Integers and Booleans are returned
+        // as doubles. Returns false if snapshots are not enabled or a value reference is not part of it.
+        bool read_output_snapshot(const unsigned int vr[], size_t nvr, double values[], double *time = nullptr) const;
+
+        virtual ~fmu_base();
 
     protected:
         IntVariable &register_integer(const std::string &name, int *ptr, const std::function<void()> &onChange = {});
@@ -177,19 +410,141 @@ namespace fmu4cpp {
                                        const std::function<bool()> &getter,
                                        const std::optional<std::function<void(bool)>> &setter);
 
+        // Variables accessed through member functions of the model, or free functions taking it as first argument,
+        // bound at compile time so that neither std::function nor an allocation is involved:
+        //
+        //  register_real<&Model::height>("height");
+        //  register_real<&Model::gain, &Model::setGain>("gain");
+        template<auto Getter, auto Setter = nullptr>
+        IntVariable &register_integer(const std::string &name) {
+            return register_bound_integer(name, &call_getter<int, Getter>, setter_of<int, Setter>());
+        }
+
+        template<auto Getter, auto Setter = nullptr>
+        RealVariable &register_real(const std::string &name) {
+            return register_bound_real(name, &call_getter<double, Getter>, setter_of<double, Setter>());
+        }
+
+        template<auto Getter, auto Setter = nullptr>
+        BoolVariable &register_boolean(const std::string &name) {
+            return register_bound_boolean(name, &call_getter<bool, Getter>, setter_of<bool, Setter>());
+        }
+
+        // FMI3 only, see NumericVariable.
+        Float32Variable &register_float32(const std::string &name, float *ptr, const std::function<void()> &onChange = {});
+        Float32Variable &register_float32(const std::string &name,
+                                          const std::function<float()> &getter,
+                                          const std::optional<std::function<void(float)>> &setter = std::nullopt);
+
+        Int8Variable &register_int8(const std::string &name, int8_t *ptr, const std::function<void()> &onChange = {});
+        Int8Variable &register_int8(const std::string &name,
+                                    const std::function<int8_t()> &getter,
+                                    const std::optional<std::function<void(int8_t)>> &setter = std::nullopt);
+
+        UInt8Variable &register_uint8(const std::string &name, uint8_t *ptr, const std::function<void()> &onChange = {});
+        UInt8Variable &register_uint8(const std::string &name,
+                                      const std::function<uint8_t()> &getter,
+                                      const std::optional<std::function<void(uint8_t)>> &setter = std::nullopt);
+
+        Int16Variable &register_int16(const std::string &name, int16_t *ptr, const std::function<void()> &onChange = {});
+        Int16Variable &register_int16(const std::string &name,
+                                      const std::function<int16_t()> &getter,
+                                      const std::optional<std::function<void(int16_t)>> &setter = std::nullopt);
+
+        UInt16Variable &register_uint16(const std::string &name, uint16_t *ptr, const std::function<void()> &onChange = {});
+        UInt16Variable &register_uint16(const std::string &name,
+                                        const std::function<uint16_t()> &getter,
+                                        const std::optional<std::function<void(uint16_t)>> &setter = std::nullopt);
+
+        UInt32Variable &register_uint32(const std::string &name, uint32_t *ptr, const std::function<void()> &onChange = {});
+        UInt32Variable &register_uint32(const std::string &name,
+                                        const std::function<uint32_t()> &getter,
+                                        const std::optional<std::function<void(uint32_t)>> &setter = std::nullopt);
+
+        Int64Variable &register_int64(const std::string &name, int64_t *ptr, const std::function<void()> &onChange = {});
+        Int64Variable &register_int64(const std::string &name,
+                                      const std::function<int64_t()> &getter,
+                                      const std::optional<std::function<void(int64_t)>> &setter = std::nullopt);
+
+        UInt64Variable &register_uint64(const std::string &name, uint64_t *ptr, const std::function<void()> &onChange = {});
+        UInt64Variable &register_uint64(const std::string &name,
+                                        const std::function<uint64_t()> &getter,
+                                        const std::optional<std::function<void(uint64_t)>> &setter = std::nullopt);
+
         StringVariable &register_string(const std::string &name, std::string *ptr, const std::function<void()> &onChange = {});
         StringVariable &register_string(const std::string &name,
                                         const std::function<std::string()> &getter,
                                         const std::optional<std::function<void(std::string)>> &setter = std::nullopt);
+        // Like register_string, but the setter receives a view of the new value instead of an owning copy.
+        StringVariable &register_string_view(const std::string &name,
+                                             const std::function<std::string()> &getter,
+                                             const std::function<void(std::string_view)> &setter);
 
         BinaryVariable &register_binary(const std::string &name, BinaryType *ptr, const std::function<void()> &onChange = {});
         BinaryVariable &register_binary(const std::string &name,
                                         const std::function<std::vector<uint8_t>()> &getter,
                                         const std::optional<std::function<void(std::vector<uint8_t>)>> &setter = std::nullopt);
+        // Like register_binary, but the setter receives a view of the new value instead of an owning copy.
+        BinaryVariable &register_binary_view(const std::string &name,
+                                             const std::function<BinaryType()> &getter,
+                                             const std::function<void(const uint8_t *, size_t)> &setter);
+
+        // Registers an array variable over contiguous, row-major storage of the given dimensions.
+        // FMI3 sees a single variable with <Dimension> elements, FMI2 sees one scalar per element, named name[i,j,...].
+        VariableArray<IntVariable> register_integer_array(const std::string &name, int *data, const std::vector<size_t> &dimensions);
+        VariableArray<RealVariable> register_real_array(const std::string &name, double *data, const std::vector<size_t> &dimensions);
+        VariableArray<BoolVariable> register_boolean_array(const std::string &name, bool *data, const std::vector<size_t> &dimensions);
+
+        // Registers the Real scalars name[0]..name[count-1], backed by base[0], base[stride], ..., with consecutive
+        // value references. Stored as one record rather than a RealVariable per element, for large signal vectors.
+        // The elements are not returned by find_real_variable and cannot be used in prepared access.
+        RealRange &register_real_range(const std::string &name, double *base, size_t count, size_t stride = 1);
+
+        // Model Exchange. Registers the continuous states name[0]..name[count-1], stored contiguously at states, and their
+        // derivatives der(name[0])..der(name[count-1]) at derivatives, as Real ranges. Returns the range of states.
+        // Meant to be called once, in the constructor.
+        RealRange &register_continuous_states(const std::string &name, double *states, double *derivatives, size_t count);
+        // Computes the derivatives, and the outputs that depend on the states, from the states, inputs and currentTime().
+        virtual void update_derivatives();
 
         virtual void enter_initialisation_mode();
+        // Models with an internal step derive from substep_fmu_base, which implements this by sub-cycling do_substep.
         virtual bool do_step(double dt) = 0;
 
+        // Called instead of do_step for models derived from substep_fmu_base.
+        virtual bool do_substep(double h);
+
+        // Hands the outputs at `time`, within the current step, to the importer through the intermediate update callback.
+        // Called after every sub-step for models with an internal step, do_step implementations call it themselves.
+        // Returns true if the importer asked for the step to end no later than `time`, in which case do_step should
+        // stop there and return true.
+        bool publish_intermediate(double time);
+        // Ends the current step at `time` instead of at its end, e.g. at a discontinuity. do_step must then have
+        // advanced the model to `time` and return true, do_substep ends the step after the current sub-step.
+        // Returns false, and the step runs to its end, if the importer does not allow early returns.
+        bool request_early_return(double time);
+        // The outputs the importer reads during intermediate updates, possibly empty.
+        [[nodiscard]] const std::vector<unsigned int> &intermediate_variables() const {
+            return intermediateVariables_;
+        }
+
+        // Declares a time event, at which do_discrete_update is called. Events scheduled before
+        // enter_initialisation_mode are discarded, so schedule the first ones from there.
+        void schedule_time_event(double time);
+        // Event handling at currentTime(), with timeEvent set if a scheduled time event is due. May schedule further events.
+        // Returns true if discrete states changed such that another iteration is needed.
+        virtual bool do_discrete_update(bool timeEvent);
+
+        // Called once per set call with the value references that were set, when input staging is enabled.
+        virtual void on_inputs_changed(const unsigned int /*vr*/[], size_t /*nvr*/) {}
+
+        // With input staging enabled, the onChange hooks of individual variables are not invoked when
+        // the importer sets values. The model is instead notified once per call through on_inputs_changed.
+        // Meant to be enabled once, in the constructor.
+        void set_input_staging(bool enabled) {
+            inputStaging_ = enabled;
+        }
+
         [[nodiscard]] double currentTime() const {
             return time_;
         }
@@ -207,6 +562,29 @@ namespace fmu4cpp {
             state_ops_ = state::make_state_ops<State>();
         }
 
+        // Registers every field declared with FMU4CPP_REFLECT as a local variable, with consecutive value references,
+        // and uses the struct as the model state (see register_state). Fields may be double, int or bool.
+        // Use the *_variable accessors below to adjust causality etc. afterwards.
+        template<typename Model, typename State>
+        void register_fields(State Model::*stateMember, const std::string &prefix = "") {
+            auto &state = static_cast<Model *>(this)->*stateMember;
+            const auto names = reflect::field_names(State::fmu4cpp_field_names());
+            size_t i = 0;
+            state.fmu4cpp_visit_fields([&](auto &...fields) {
+                if (names.size() != sizeof...(fields)) {
+                    throw std::logic_error("FMU4CPP_REFLECT: " + std::to_string(names.size()) + " names for " +
+                                           std::to_string(sizeof...(fields)) + " fields");
+                }
+                (register_field(prefix + names[i++], &fields), ...);
+            });
+            register_state(stateMember);
+        }
+
+        // Throws if no variable of that type is registered under the given name.
+        IntVariable &int_variable(std::string_view name);
+        RealVariable &real_variable(std::string_view name);
+        BoolVariable &bool_variable(std::string_view name);
+
     private:
         fmu_data data_;
 
@@ -216,27 +594,376 @@ namespace fmu4cpp {
         std::optional<double> stop_;
         std::optional<double> tolerance_;
 
-        std::vector<IntVariable> integers_;
-        std::unordered_map<unsigned int, size_t> vrToIntegerIndices_;
+        bool inputStaging_{false};
 
-        std::vector<RealVariable> reals_;
-        std::unordered_map<unsigned int, size_t> vrToRealIndices_;
+        std::optional<double> internalStep_;
+        internal_step internalStepKind_{internal_step::FIXED};
+        double tickOrigin_{0};
+        uint64_t ticks_{0};
+
+        // Makes step() advance the model through do_substep instead of do_step, see substep_fmu_base
+        void set_internal_step(double stepSize, internal_step kind);
+        bool sub_cycle(double dt);
+        bool substep_ends_step();
+
+        intermediate_update_callback intermediateUpdate_;
+        bool earlyReturnAllowed_{false};
+        std::vector<unsigned int> intermediateVariables_;
+        double stepEnd_{0};
+        std::optional<double> pendingReturn_;// requested by the importer, possibly later than the last intermediate update
+        std::optional<double> earlyReturn_;
+
+        bool eventModeUsed_{false};
+        std::priority_queue<double, std::vector<double>, std::greater<>> timeEvents_;
+
+        bool step_to_events();
+        void handle_events();
+
+        double *states_{nullptr};
+        double *derivatives_{nullptr};
+        size_t nStates_{0};
+        bool modelExchange_{false};
+        // Set when time, states or inputs change in Model Exchange, so that update_derivatives runs before the next read
+        mutable bool stale_{false};
 
+        template<typename T>
+        friend class VarHandle;
+        friend class substep_fmu_base;
+
+        void invalidate() {
+            stale_ = modelExchange_;
+        }
+
+        void refresh() const {
+            if (stale_) evaluate();
+        }
+
+        // A single value set through a VarHandle, with the same checks and notifications as set_real etc.
+        template<typename V, typename T>
+        void set_variable(V &variable, T value) {
+            const auto vr = variable.value_reference();
+            check_settable(&vr, 1);
+            invalidate();
+            variable.set_unchecked(std::move(value), !inputStaging_);
+            if (inputStaging_) on_inputs_changed(&vr, 1);
+        }
+
+        void evaluate() const;
+        void check_state_count(size_t nx) const;
+        bool hasArrays_{false};
+        bool hasRanges_{false};
+
+        fmu_mode mode_{fmu_mode::INSTANTIATED};
+        mutable std::vector<uint8_t> settable_;// per value reference, the modes in which it may be set
+
+        struct name_entry {
+            std::string_view name;// of the variable, or of a whole RealRange
+            unsigned int vr;
+            size_t size;
+        };
+        // All names in lexicographic order, so that the names under a prefix are adjacent. Built on first use,
+        // and again after more variables have been registered, as the names it points to may have moved.
+        mutable std::vector<name_entry> sortedNames_;
+        mutable size_t sortedNamesFor_{0};
+
+        const std::vector<name_entry> &sorted_names() const;
+
+        struct output_snapshot;
+        std::unique_ptr<output_snapshot> snapshot_;
+
+        void publish_output_snapshot();
+
+        const std::vector<uint8_t> &settable_modes() const;
+        void check_settable(const unsigned int vr[], size_t nvr) const;
+        [[noreturn]] void not_settable(const unsigned int vr[], size_t nvr) const;
+
+        template<typename T>
+        struct tracked_outputs {
+            std::vector<uint32_t> indices;// index into the vector holding variables of this type
+            std::vector<T> shadow;        // value seen at the last update
+            std::vector<uint64_t> versions;
+        };
+
+        bool changeTracking_{false};
+        uint64_t changeCounter_{0};
+        tracked_outputs<int> trackedIntegers_;
+        tracked_outputs<double> trackedReals_;
+        tracked_outputs<bool> trackedBooleans_;
+        tracked_outputs<std::string> trackedStrings_;
+        tracked_outputs<BinaryType> trackedBinary_;
+        tracked_outputs<double> trackedRanges_;// indexed by value reference instead
+        std::vector<unsigned int> changedBuffer_;
+        std::function<void(const unsigned int vr[], size_t nvr)> outputsChanged_;
+
+        void enable_change_tracking();
+        void update_change_tracking();
+
+        template<typename T, typename V>
+        void track_outputs(const std::vector<V> &vars, tracked_outputs<T> &tracked);
+
+        template<typename T, typename V>
+        void update_tracked(const std::vector<V> &vars, tracked_outputs<T> &tracked);
+
+        template<typename T, typename V>
+        void collect_changed(const std::vector<V> &vars, const tracked_outputs<T> &tracked,
+                             uint64_t since, std::vector<unsigned int> &vrs) const;
+
+        std::vector<IntVariable> integers_;
+        std::vector<RealVariable> reals_;
         std::vector<BoolVariable> booleans_;
-        std::unordered_map<unsigned int, size_t> vrToBooleanIndices_;
 
         std::vector<StringVariable> strings_;
         std::vector<std::string> stringBuffer_;
-        std::unordered_map<unsigned int, size_t> vrToStringIndices_;
 
         std::vector<BinaryVariable> binary_;
         std::vector<std::vector<uint8_t>> binaryBuffer_;
-        std::unordered_map<unsigned int, size_t> vrToBinaryIndices_;
+
+        struct vr_entry {
+            value_type type;
+            bool range;    // element of a RealRange
+            uint32_t index;// index into the vector holding variables of this type, or into realRanges_
+        };
+
+        // value references are handed out sequentially, so this is indexed directly by value reference
+        std::vector<vr_entry> vrTable_;
+        std::unordered_multimap<uint64_t, unsigned int> nameIndex_;// name hash -> value reference
+
+        std::vector<RealRange> realRanges_;
+
+        // Structure-of-arrays view of the numeric variables of one type, indexed like the variable vector.
+        // Lets bulk get/set find the backing storage without touching the variable objects,
+        // and detect requests that map to one contiguous block of memory.
+        template<typename T>
+        struct value_slots {
+            std::vector<T *> ptrs;              // backing storage, nullptr for getter/setter backed variables
+            std::vector<bound_getter<T>> getters;// getter bound at compile time, invoked with the instance
+            std::vector<unsigned> vrs;          // value reference of each slot
+            std::vector<uint8_t> linked;        // 1 if both vr and address directly follow those of the previous slot
+
+            void add(unsigned int vr, T *ptr, bound_getter<T> getter = nullptr) {
+                const bool continues = ptr && !ptrs.empty() && ptrs.back() &&
+                                       ptrs.back() + 1 == ptr && vrs.back() + 1 == vr;
+                ptrs.push_back(ptr);
+                getters.push_back(getter);
+                vrs.push_back(vr);
+                linked.push_back(continues);
+            }
+
+            [[nodiscard]] size_t size() const {
+                return ptrs.size();
+            }
+        };
+
+        value_slots<int> integerSlots_;
+        value_slots<double> realSlots_;
+        value_slots<bool> booleanSlots_;
+
+        template<typename T>
+        struct numeric_variables {
+            std::vector<NumericVariable<T>> vars;
+            value_slots<T> slots;
+        };
+
+        std::tuple<numeric_variables<float>,
+                   numeric_variables<int8_t>, numeric_variables<uint8_t>,
+                   numeric_variables<int16_t>, numeric_variables<uint16_t>,
+                   numeric_variables<uint32_t>,
+                   numeric_variables<int64_t>, numeric_variables<uint64_t>>
+                numerics_;
+
+        template<typename T>
+        numeric_variables<T> &numerics() {
+            return std::get<numeric_variables<T>>(numerics_);
+        }
+
+        template<typename T>
+        const numeric_variables<T> &numerics() const {
+            return std::get<numeric_variables<T>>(numerics_);
+        }
+
+        template<typename T>
+        std::vector<typename variable_of<T>::type> &variables_of() {
+            if constexpr (std::is_same_v<T, int>) return integers_;
+            else if constexpr (std::is_same_v<T, double>) return reals_;
+            else if constexpr (std::is_same_v<T, bool>) return booleans_;
+            else if constexpr (std::is_same_v<T, std::string>) return strings_;
+            else if constexpr (std::is_same_v<T, BinaryType>) return binary_;
+            else return numerics<T>().vars;
+        }
+
+        template<typename T>
+        static constexpr value_type type_of() {
+            if constexpr (std::is_same_v<T, int>) return value_type::INTEGER;
+            else if constexpr (std::is_same_v<T, double>) return value_type::REAL;
+            else if constexpr (std::is_same_v<T, bool>) return value_type::BOOLEAN;
+            else if constexpr (std::is_same_v<T, std::string>) return value_type::STRING;
+            else if constexpr (std::is_same_v<T, BinaryType>) return value_type::BINARY;
+            else if constexpr (std::is_same_v<T, float>) return value_type::FLOAT32;
+            else if constexpr (std::is_same_v<T, int8_t>) return value_type::INT8;
+            else if constexpr (std::is_same_v<T, uint8_t>) return value_type::UINT8;
+            else if constexpr (std::is_same_v<T, int16_t>) return value_type::INT16;
+            else if constexpr (std::is_same_v<T, uint16_t>) return value_type::UINT16;
+            else if constexpr (std::is_same_v<T, uint32_t>) return value_type::UINT32;
+            else if constexpr (std::is_same_v<T, int64_t>) return value_type::INT64;
+            else if constexpr (std::is_same_v<T, uint64_t>) return value_type::UINT64;
+            else static_assert(reflect::always_false<T>::value, "Unsupported variable type");
+        }
+
+        // The RealRange the value reference is an element of, or nullptr
+        [[nodiscard]] const RealRange *range_of(unsigned int vr) const {
+            if (vr >= vrTable_.size() || !vrTable_[vr].range) return nullptr;
+            return &realRanges_[vrTable_[vr].index];
+        }
+
+        // The elements of all RealRanges as variables. Created on every call,
+        // so only meant for one-off passes like writing the model description.
+        [[nodiscard]] std::vector<RealVariable> range_elements() const;
+
+        // Appends those of the range elements that match the predicate
+        static void collect_ranges(std::vector<const VariableBase *> &vars, const std::vector<RealVariable> &elements,
+                                   const std::function<bool(const VariableBase &)> &predicate = [](auto &) { return true; });
+
+        // Appends the NumericVariables matching the predicate
+        void collect_numerics(std::vector<const VariableBase *> &vars,
+                              const std::function<bool(const VariableBase &)> &predicate = [](auto &) { return true; }) const;
+
+        template<typename T>
+        NumericVariable<T> &register_numeric(const std::string &name, T *ptr, const std::function<void()> &onChange);
+        template<typename T>
+        NumericVariable<T> &register_numeric(const std::string &name,
+                                             const std::function<T()> &getter,
+                                             const std::optional<std::function<void(T)>> &setter);
+
+        unsigned int next_value_reference(const std::string &name, value_type type, size_t index);
+        [[nodiscard]] size_t index_of(unsigned int vr, value_type type) const;
+        [[nodiscard]] size_t access_index(unsigned int vr, value_type type) const;
+
+        template<typename V>
+        const V *find_variable(std::string_view name, value_type type, const std::vector<V> &vars) const;
+
+        template<typename T, typename U, typename V>
+        void get_values(value_type type, const std::vector<V> &vars, const value_slots<T> &slots,
+                        const unsigned int vr[], size_t nvr, U value[]) const;
+
+        template<typename T, typename U, typename V>
+        void set_values(value_type type, std::vector<V> &vars, const value_slots<T> &slots,
+                        const unsigned int vr[], size_t nvr, const U value[]);
+
+        template<typename T, typename U, typename V>
+        void write_values(value_type type, std::vector<V> &vars, const value_slots<T> &slots,
+                          const unsigned int vr[], size_t nvr, const U value[]);
+
+        // These return the number of values used, which differs from nvr if arrays are involved
+        template<typename T, typename U, typename V>
+        size_t get_array_values(value_type type, const std::vector<V> &vars, const value_slots<T> &slots,
+                                const unsigned int vr[], size_t nvr, U value[], size_t nValues) const;
+
+        template<typename T, typename U, typename V>
+        void set_array_values(value_type type, std::vector<V> &vars, const value_slots<T> &slots,
+                              const unsigned int vr[], size_t nvr, const U value[], size_t nValues);
+
+        template<typename T, typename U, typename V>
+        size_t write_array_values(value_type type, std::vector<V> &vars, const value_slots<T> &slots,
+                                  const unsigned int vr[], size_t nvr, const U value[], size_t nValues);
+
+        // Real requests once ranges are registered. Runs of range elements are copied with their stride,
+        // the value references in between are handed to other(vr, nvr, value, nValues), which returns the number of values used.
+        template<typename F>
+        void get_range_values(const unsigned int vr[], size_t nvr, double value[], size_t nValues, F &&other) const;
+
+        template<typename F>
+        void write_range_values(const unsigned int vr[], size_t nvr, const double value[], size_t nValues, F &&other);
+
+        template<typename V, typename T, typename F>
+        VariableArray<V> register_array(const std::string &name, T *data, const std::vector<size_t> &dimensions,
+                                        std::vector<V> &vars, F &&registerElement);
+
+        template<typename T, typename V>
+        void prepare_runs(access_plan &plan, const std::vector<V> &vars, const value_slots<T> &slots,
+                          const unsigned int vr[], size_t nvr) const;
+
+        template<typename T, typename U, typename V>
+        void get_values(const access_plan &plan, value_type type, const std::vector<V> &vars,
+                        const value_slots<T> &slots, U value[]) const;
+
+        template<typename T, typename U, typename V>
+        void set_values(const access_plan &plan, value_type type, std::vector<V> &vars,
+                        const value_slots<T> &slots, const U value[]);
+
+        IntVariable &register_bound_integer(const std::string &name, bound_getter<int> getter, bound_setter<int> setter);
+        RealVariable &register_bound_real(const std::string &name, bound_getter<double> getter, bound_setter<double> setter);
+        BoolVariable &register_bound_boolean(const std::string &name, bound_getter<bool> getter, bound_setter<bool> setter);
+
+        template<auto Accessor>
+        static auto &model_from(void *self) {
+            using Model = typename bound::model_of<decltype(Accessor)>::type;
+            return static_cast<Model &>(*static_cast<fmu_base *>(self));
+        }
+
+        template<typename T, auto Getter>
+        static T call_getter(void *self) {
+            return static_cast<T>(std::invoke(Getter, model_from<Getter>(self)));
+        }
+
+        template<typename T, auto Setter>
+        static void call_setter(void *self, T value) {
+            std::invoke(Setter, model_from<Setter>(self), value);
+        }
+
+        template<typename T, auto Setter>
+        static bound_setter<T> setter_of() {
+            if constexpr (std::is_null_pointer_v<decltype(Setter)>) {
+                return nullptr;
+            } else {
+                return &call_setter<T, Setter>;
+            }
+        }
+
+        void register_field(const std::string &name, int *ptr) {
+            register_integer(name, ptr);
+        }
+
+        void register_field(const std::string &name, double *ptr) {
+            register_real(name, ptr);
+        }
+
+        void register_field(const std::string &name, bool *ptr) {
+            register_boolean(name, ptr);
+        }
+
+        template<typename T>
+        void register_field(const std::string &, T *) {
+            static_assert(reflect::always_false<T>::value, "Unsupported field type, expected double, int or bool");
+        }
 
         std::function<void *(void *)> get_state_ptr_{nullptr};
         const state::Ops *state_ops_{nullptr};
     };
 
+    // Base for models that advance in internal steps of their own rather than per communication step,
+    // implementing do_substep instead of do_step. currentTime() follows each sub-step, and with FIXED is kept as
+    // start time + ticks * stepSize, so it does not drift. Snapshots and change tracking are still only updated
+    // once per communication step.
+    class substep_fmu_base : public fmu_base {
+
+    protected:
+        substep_fmu_base(fmu_data data, double stepSize, internal_step kind = internal_step::FIXED)
+            : fmu_base(std::move(data)) {
+            set_internal_step(stepSize, kind);
+        }
+
+        bool do_substep(double h) override = 0;
+
+        bool do_step(double dt) final {
+            return sub_cycle(dt);
+        }
+    };
+
+    template<typename T>
+    void VarHandle<T>::set(T value) {
+        owner_->set_variable(variable(), std::move(value));
+    }
+
 
 #define FMU4CPP_INSTANTIATE(MODELCLASS)                                                         \
     std::unique_ptr<fmu4cpp::fmu_base> fmu4cpp::createInstance(const fmu4cpp::fmu_data &data) { \
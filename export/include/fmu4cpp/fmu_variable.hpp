@@ -4,16 +4,22 @@
 
 #include "variable_access.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace fmu4cpp {
 
+    class fmu_base;
+
     using BinaryType = std::vector<uint8_t>;
 
     enum class causality_t {
@@ -46,6 +52,14 @@ namespace fmu4cpp {
 
     class VariableBase {
 
+    public:
+        // Shared by the elements of an array variable, see fmu_base::register_real_array.
+        struct array_info {
+            std::string name;
+            std::vector<size_t> dimensions;
+            size_t size;// number of elements
+        };
+
     protected:
         causality_t causality_ = causality_t::LOCAL;
         std::optional<variability_t> variability_;
@@ -82,6 +96,11 @@ namespace fmu4cpp {
             return initial_;
         }
 
+        // Whether the causality and initial attributes allow the value to be set by the importer.
+        [[nodiscard]] bool writable() const {
+            return !(causality_ == causality_t::LOCAL || (causality_ == causality_t::OUTPUT && initial_ != initial_t::EXACT) || causality_ == causality_t::INDEPENDENT);
+        }
+
         [[nodiscard]] std::string getDescription() const {
             return description_;
         }
@@ -97,22 +116,39 @@ namespace fmu4cpp {
             return annotations_;
         }
 
+        // The array this variable is an element of, or nullptr for scalars.
+        [[nodiscard]] const array_info *array() const {
+            return array_.get();
+        }
+
+        // Position within the array, in row-major order. The first element stands for the whole array in FMI3.
+        [[nodiscard]] size_t array_offset() const {
+            return arrayOffset_;
+        }
+
         virtual ~VariableBase() = default;
 
     private:
+        friend class fmu_base;
+
         std::string name_;
         unsigned int vr_;
         size_t index_;
+
+        std::shared_ptr<const array_info> array_;
+        size_t arrayOffset_{0};
     };
 
     template<class T, class V>
     class Variable : public VariableBase {
 
     public:
+        using value_type = T;
+
         Variable(
                 const std::string &name,
                 unsigned int vr, size_t index, T *ptr, const std::function<void()> &onChange)
-            : VariableBase(name, vr, index), access_(std::make_unique<PtrAccess<T>>(ptr, onChange)) {}
+            : VariableBase(name, vr, index), ptr_(ptr), hasOnChange_(static_cast<bool>(onChange)), onChange_(onChange) {}
 
         Variable(
                 const std::string &name,
@@ -122,17 +158,32 @@ namespace fmu4cpp {
             : VariableBase(name, vr, index),
               access_(std::make_unique<LambdaAccess<T>>(std::move(getter), std::move(setter))) {}
 
+        Variable(
+                const std::string &name,
+                unsigned int vr, size_t index,
+                void *context, bound_getter<T> getter, bound_setter<T> setter)
+            : VariableBase(name, vr, index), context_(context), boundGetter_(getter), boundSetter_(setter) {}
+
         [[nodiscard]] T get() const {
+            if (ptr_) return *ptr_;
+            if (boundGetter_) return boundGetter_(context_);
 
             return access_->get();
         }
 
-        void set(T value) {
-            if (causality_ == causality_t::LOCAL || (causality_ == causality_t::OUTPUT && initial_ != initial_t::EXACT) || causality_ == causality_t::INDEPENDENT) {
-                throw std::logic_error("Cannot set value for variable with causality: " + to_string(causality_));
-            }
+        // notify=false skips the onChange hook, used when the model is notified once per batch instead.
+        void set(T value, bool notify = true) {
+            check_writable();
+            set_unchecked(std::move(value), notify);
+        }
 
-            access_->set(value);
+        // Pointer to the backing storage, or nullptr if the variable is backed by a getter/setter pair.
+        [[nodiscard]] T *ptr() const {
+            return ptr_;
+        }
+
+        [[nodiscard]] bool hasOnChange() const {
+            return hasOnChange_;
         }
 
         V &setDescription(const std::string &description) {
@@ -174,7 +225,57 @@ namespace fmu4cpp {
             return *static_cast<V *>(this);
         }
 
+    protected:
+        void check_writable() const {
+            if (!writable()) {
+                throw std::logic_error("Cannot set value for variable with causality: " + to_string(causality_));
+            }
+        }
+
+        // Assigns to the backing storage in place, reusing its capacity. Returns false if there is no such storage.
+        template<typename... Args>
+        bool assign_inplace(bool notify, Args &&...args) {
+            if (!ptr_) return false;
+            ptr_->assign(std::forward<Args>(args)...);
+            if (notify) notify_change();
+            return true;
+        }
+
+        void notify_change() {
+            if (hasOnChange_) onChange_();
+        }
+
+        // fmu_base checks writability once for all value references of a call before using this
+        void set_unchecked(T value, bool notify) {
+            if (ptr_) {
+                *ptr_ = std::move(value);
+                if (notify) notify_change();
+                return;
+            }
+            if (boundGetter_) {
+                if (!boundSetter_) {
+                    throw std::logic_error("Variable " + name() + " was registered without a setter");
+                }
+                boundSetter_(context_, std::move(value));
+                return;
+            }
+
+            access_->set(value);
+        }
+
     private:
+        friend class fmu_base;
+
+        // pointer-backed variables are accessed directly, without going through VariableAccess
+        T *ptr_{nullptr};
+        bool hasOnChange_{false};
+        std::function<void()> onChange_;
+
+        // so are variables with accessors bound at compile time
+        void *context_{nullptr};
+        bound_getter<T> boundGetter_{nullptr};
+        bound_setter<T> boundSetter_{nullptr};
+
         std::shared_ptr<VariableAccess<T>> access_;
     };
 
@@ -193,6 +294,12 @@ namespace fmu4cpp {
                 const std::optional<std::function<void(int)>> &setter)
             : Variable(name, vr, index, getter, setter) {}
 
+        IntVariable(
+                const std::string &name,
+                unsigned int vr, size_t index,
+                void *context, bound_getter<int> getter, bound_setter<int> setter)
+            : Variable(name, vr, index, context, getter, setter) {}
+
         [[nodiscard]] std::optional<int> getMin() const {
             return min_;
         }
@@ -237,6 +344,15 @@ namespace fmu4cpp {
             variability_ = variability_t::CONTINUOUS;
         }
 
+        RealVariable(
+                const std::string &name,
+                unsigned int vr, size_t index,
+                void *context, bound_getter<double> getter, bound_setter<double> setter)
+            : Variable(name, vr, index, context, getter, setter) {
+
+            variability_ = variability_t::CONTINUOUS;
+        }
+
         [[nodiscard]] std::optional<double> getMin() const {
             return min_;
         }
@@ -264,10 +380,21 @@ namespace fmu4cpp {
             return *this;
         }
 
+        // Value reference of the continuous state this is the derivative of, for Model Exchange
+        [[nodiscard]] std::optional<unsigned int> getDerivative() const {
+            return derivative_;
+        }
+
+        RealVariable &setDerivative(const std::optional<unsigned int> &stateVr) {
+            derivative_ = stateVr;
+            return *this;
+        }
+
     private:
         std::optional<double> min_;
         std::optional<double> max_;
         std::optional<std::string> unit_;
+        std::optional<unsigned int> derivative_;
     };
 
     class BoolVariable final : public Variable<bool, BoolVariable> {
@@ -284,8 +411,70 @@ namespace fmu4cpp {
                 const std::function<bool()> &getter,
                 const std::optional<std::function<void(bool)>> &setter)
             : Variable(name, vr, index, getter, setter) {}
+
+        BoolVariable(
+                const std::string &name,
+                unsigned int vr, size_t index,
+                void *context, bound_getter<bool> getter, bound_setter<bool> setter)
+            : Variable(name, vr, index, context, getter, setter) {}
     };
 
+    // The FMI3 numeric types without an FMI2 counterpart, see the aliases below.
+    // Only declared in the FMI3 model description.
+    template<typename T>
+    class NumericVariable final : public Variable<T, NumericVariable<T>> {
+
+    public:
+        NumericVariable(
+                const std::string &name,
+                unsigned int vr, size_t index, T *ptr, const std::function<void()> &onChange)
+            : Variable<T, NumericVariable>(name, vr, index, ptr, onChange) {
+
+            if constexpr (std::is_floating_point_v<T>) this->variability_ = variability_t::CONTINUOUS;
+        }
+
+        NumericVariable(
+                const std::string &name,
+                unsigned int vr, size_t index,
+                const std::function<T()> &getter,
+                const std::optional<std::function<void(T)>> &setter)
+            : Variable<T, NumericVariable>(name, vr, index, getter, setter) {
+
+            if constexpr (std::is_floating_point_v<T>) this->variability_ = variability_t::CONTINUOUS;
+        }
+
+        [[nodiscard]] std::optional<T> getMin() const {
+            return min_;
+        }
+
+        [[nodiscard]] std::optional<T> getMax() const {
+            return max_;
+        }
+
+        NumericVariable &setMin(const std::optional<T> &min) {
+            min_ = min;
+            return *this;
+        }
+
+        NumericVariable &setMax(const std::optional<T> &max) {
+            max_ = max;
+            return *this;
+        }
+
+    private:
+        std::optional<T> min_;
+        std::optional<T> max_;
+    };
+
+    using Float32Variable = NumericVariable<float>;
+    using Int8Variable = NumericVariable<int8_t>;
+    using UInt8Variable = NumericVariable<uint8_t>;
+    using Int16Variable = NumericVariable<int16_t>;
+    using UInt16Variable = NumericVariable<uint16_t>;
+    using UInt32Variable = NumericVariable<uint32_t>;
+    using Int64Variable = NumericVariable<int64_t>;
+    using UInt64Variable = NumericVariable<uint64_t>;
+
     class StringVariable : public Variable<std::string, StringVariable> {
 
     public:
@@ -300,6 +489,45 @@ namespace fmu4cpp {
                 const std::function<std::string()> &getter,
                 const std::optional<std::function<void(std::string)>> &setter)
             : Variable(name, vr, index, getter, setter) {}
+
+        // The setter receives a view that is only valid for the duration of the call.
+        StringVariable(
+                const std::string &name,
+                unsigned int vr, size_t index,
+                const std::function<std::string()> &getter,
+                std::function<void(std::string_view)> viewSetter)
+            : Variable(name, vr, index, getter, std::nullopt), viewSetter_(std::move(viewSetter)) {}
+
+        void set(std::string value, bool notify = true) {
+            check_writable();
+            if (ptr()) {
+                set_unchecked(std::move(value), notify);
+            } else {
+                assign_unchecked(value, notify);
+            }
+        }
+
+        // Sets the value without creating an intermediate std::string.
+        void assign(std::string_view value, bool notify = true) {
+            check_writable();
+            assign_unchecked(value, notify);
+        }
+
+    private:
+        friend class fmu_base;
+
+        std::function<void(std::string_view)> viewSetter_;
+
+        // see Variable::set_unchecked
+        void assign_unchecked(std::string_view value, bool notify) {
+            if (assign_inplace(notify, value.data(), value.size())) return;
+
+            if (viewSetter_) {
+                viewSetter_(value);
+            } else {
+                set_unchecked(std::string(value), notify);
+            }
+        }
     };
 
     class BinaryVariable : public Variable<BinaryType, BinaryVariable> {
@@ -316,6 +544,316 @@ namespace fmu4cpp {
                 const std::function<BinaryType()> &getter,
                 const std::optional<std::function<void(BinaryType)>> &setter)
             : Variable(name, vr, index, getter, setter) {}
+
+        // The setter receives a view that is only valid for the duration of the call.
+        BinaryVariable(
+                const std::string &name,
+                unsigned int vr, size_t index,
+                const std::function<BinaryType()> &getter,
+                std::function<void(const uint8_t *, size_t)> viewSetter)
+            : Variable(name, vr, index, getter, std::nullopt), viewSetter_(std::move(viewSetter)) {}
+
+        void set(BinaryType value, bool notify = true) {
+            check_writable();
+            if (ptr()) {
+                set_unchecked(std::move(value), notify);
+            } else {
+                assign_unchecked(value.data(), value.size(), notify);
+            }
+        }
+
+        // Sets the value without creating an intermediate BinaryType.
+        void assign(const uint8_t *data, size_t size, bool notify = true) {
+            check_writable();
+            assign_unchecked(data, size, notify);
+        }
+
+    private:
+        friend class fmu_base;
+
+        std::function<void(const uint8_t *, size_t)> viewSetter_;
+
+        // see Variable::set_unchecked
+        void assign_unchecked(const uint8_t *data, size_t size, bool notify) {
+            if (const auto p = ptr(); p && p->data() == data) {
+                // assigning a vector from its own range is not allowed
+                p->resize(size);
+                if (notify) notify_change();
+                return;
+            }
+            if (assign_inplace(notify, data, data + size)) return;
+
+            if (viewSetter_) {
+                viewSetter_(data, size);
+            } else {
+                set_unchecked(BinaryType(data, data + size), notify);
+            }
+        }
+    };
+
+    // Handle to the elements of an array variable. Attributes are applied to every element.
+    template<class V>
+    class VariableArray {
+
+    public:
+        VariableArray(std::vector<V> &vars, size_t first, size_t size)
+            : vars_(vars), first_(first), size_(size) {}
+
+        [[nodiscard]] size_t size() const {
+            return size_;
+        }
+
+        V &operator[](size_t i) {
+            return vars_[first_ + i];
+        }
+
+        template<typename F>
+        VariableArray &apply(F &&f) {
+            for (size_t i = 0; i < size_; i++) {
+                f(vars_[first_ + i]);
+            }
+            return *this;
+        }
+
+        VariableArray &setDescription(const std::string &description) {
+            return apply([&](V &v) { v.setDescription(description); });
+        }
+
+        VariableArray &setCausality(causality_t causality) {
+            return apply([&](V &v) { v.setCausality(causality); });
+        }
+
+        VariableArray &setVariability(variability_t variability) {
+            return apply([&](V &v) { v.setVariability(variability); });
+        }
+
+        VariableArray &setInitial(initial_t initial) {
+            return apply([&](V &v) { v.setInitial(initial); });
+        }
+
+        template<typename T>
+        VariableArray &setMin(const T &min) {
+            return apply([&](V &v) { v.setMin(min); });
+        }
+
+        template<typename T>
+        VariableArray &setMax(const T &max) {
+            return apply([&](V &v) { v.setMax(max); });
+        }
+
+        VariableArray &setUnit(const std::optional<std::string> &unit) {
+            return apply([&](V &v) { v.setUnit(unit); });
+        }
+
+    private:
+        std::vector<V> &vars_;
+        size_t first_;
+        size_t size_;
+    };
+
+    // Real variables name[0]..name[size-1] over strided storage, kept as a single record, see fmu_base::register_real_range.
+    // Attributes apply to every element. Element variables are only created on demand, e.g. for the model description.
+    class RealRange {
+
+    public:
+        RealRange(const std::string &name, unsigned int vr, double *base, size_t size, size_t stride)
+            : prototype_(name, vr, vr + 1, base, {}), base_(base), size_(size), stride_(stride) {}
+
+        [[nodiscard]] const std::string &name() const {
+            return prototype_.name();
+        }
+
+        // Value reference of the first element, the others follow consecutively
+        [[nodiscard]] unsigned int value_reference() const {
+            return prototype_.value_reference();
+        }
+
+        [[nodiscard]] size_t size() const {
+            return size_;
+        }
+
+        [[nodiscard]] size_t stride() const {
+            return stride_;
+        }
+
+        // Carries the attributes shared by all elements
+        [[nodiscard]] const RealVariable &attributes() const {
+            return prototype_;
+        }
+
+        [[nodiscard]] double *ptr(size_t offset) const {
+            return base_ + offset * stride_;
+        }
+
+        [[nodiscard]] std::string element_name(size_t offset) const {
+            const auto index = "[" + std::to_string(offset) + "]";
+            if (derivativeOf_) return "der(" + derivativeOf_->name + index + ")";
+            return name() + index;
+        }
+
+        [[nodiscard]] RealVariable element(size_t offset) const {
+            const auto vr = value_reference() + static_cast<unsigned int>(offset);
+            RealVariable v(element_name(offset), vr, vr + 1, ptr(offset), {});
+            v.setCausality(prototype_.causality())
+                    .setDescription(prototype_.getDescription())
+                    .setMin(prototype_.getMin())
+                    .setMax(prototype_.getMax())
+                    .setUnit(prototype_.getUnit());
+            if (const auto variability = prototype_.variability()) v.setVariability(*variability);
+            if (const auto initial = prototype_.initial()) v.setInitial(*initial);
+            if (derivativeOf_) v.setDerivative(derivativeOf_->vr + static_cast<unsigned int>(offset));
+            return v;
+        }
+
+        void read(size_t offset, size_t n, double *values) const {
+            const double *src = ptr(offset);
+            if (stride_ == 1) {
+                std::copy(src, src + n, values);
+                return;
+            }
+            for (size_t i = 0; i < n; i++) {
+                values[i] = src[i * stride_];
+            }
+        }
+
+        void write(size_t offset, size_t n, const double *values) {
+            double *dst = ptr(offset);
+            if (stride_ == 1) {
+                std::copy(values, values + n, dst);
+                return;
+            }
+            for (size_t i = 0; i < n; i++) {
+                dst[i * stride_] = values[i];
+            }
+        }
+
+        RealRange &setDescription(const std::string &description) {
+            prototype_.setDescription(description);
+            return *this;
+        }
+
+        RealRange &setCausality(causality_t causality) {
+            prototype_.setCausality(causality);
+            return *this;
+        }
+
+        RealRange &setVariability(variability_t variability) {
+            prototype_.setVariability(variability);
+            return *this;
+        }
+
+        RealRange &setInitial(initial_t initial) {
+            prototype_.setInitial(initial);
+            return *this;
+        }
+
+        RealRange &setMin(const std::optional<double> &min) {
+            prototype_.setMin(min);
+            return *this;
+        }
+
+        RealRange &setMax(const std::optional<double> &max) {
+            prototype_.setMax(max);
+            return *this;
+        }
+
+        RealRange &setUnit(const std::optional<std::string> &unit) {
+            prototype_.setUnit(unit);
+            return *this;
+        }
+
+        // Makes the elements the derivatives of the elements of states, named der(states[i])
+        RealRange &setDerivativeOf(const RealRange &states) {
+            derivativeOf_ = {states.name(), states.value_reference()};
+            return *this;
+        }
+
+    private:
+        struct state_ref {
+            std::string name;
+            unsigned int vr;
+        };
+
+        RealVariable prototype_;
+        std::optional<state_ref> derivativeOf_;
+        double *base_;
+        size_t size_;
+        size_t stride_;
+    };
+
+    // The variable class holding values of type T
+    template<typename T>
+    struct variable_of {
+        using type = NumericVariable<T>;
+    };
+
+    template<>
+    struct variable_of<int> {
+        using type = IntVariable;
+    };
+
+    template<>
+    struct variable_of<double> {
+        using type = RealVariable;
+    };
+
+    template<>
+    struct variable_of<bool> {
+        using type = BoolVariable;
+    };
+
+    template<>
+    struct variable_of<std::string> {
+        using type = StringVariable;
+    };
+
+    template<>
+    struct variable_of<BinaryType> {
+        using type = BinaryVariable;
+    };
+
+    // Typed access to a variable for C++ code using the model in-process, see fmu_base::handle.
+    // Resolved once, so that reading a pointer-backed variable costs the same as reading the member itself.
+    // Setting is checked and notified like a single value passed to set_real etc.
+    template<typename T>
+    class VarHandle {
+
+    public:
+        using variable_type = typename variable_of<T>::type;
+
+        VarHandle() = default;
+
+        VarHandle(fmu_base &owner, std::vector<variable_type> &vars, size_t index)
+            : owner_(&owner), vars_(&vars), index_(index), ptr_(vars[index].ptr()) {}
+
+        [[nodiscard]] T get() const {
+            if (ptr_) return *ptr_;
+            return variable().get();
+        }
+
+        // Like the set_* functions, throws if the variable cannot be set in the current mode, stages inputs
+        // for on_inputs_changed and marks the outputs of a Model Exchange instance for re-evaluation.
+        // Defined in fmu_base.hpp.
+        void set(T value);
+
+        // Stays valid when more variables are registered, unlike references to the variable itself
+        [[nodiscard]] variable_type &variable() const {
+            return (*vars_)[index_];
+        }
+
+        [[nodiscard]] unsigned int value_reference() const {
+            return variable().value_reference();
+        }
+
+        explicit operator bool() const {
+            return vars_ != nullptr;
+        }
+
+    private:
+        fmu_base *owner_{nullptr};
+        std::vector<variable_type> *vars_{nullptr};
+        size_t index_{0};
+        T *ptr_{nullptr};
     };
 
     bool requires_start(const VariableBase &v);
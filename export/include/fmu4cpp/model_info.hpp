@@ -29,6 +29,10 @@ namespace fmu4cpp {
         bool canBeInstantiatedOnlyOncePerProcess{false};
         bool canGetAndSetFMUstate{false};
         bool canSerializeFMUstate{false};
+        // FMI3 Co-Simulation, see fmu_base::set_event_mode_used and fmu_base::publish_intermediate
+        bool hasEventMode{false};
+        bool providesIntermediateUpdate{false};
+        bool canReturnEarlyAfterIntermediateUpdate{false};
 
         std::optional<default_experiment> defaultExperiment;
     };
@@ -0,0 +1,60 @@
+#ifndef FMU4CPP_REFLECT_HPP
+#define FMU4CPP_REFLECT_HPP
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Declares the fields of a trivially copyable struct, so that they can be registered in one go
+// using fmu_base::register_fields. Place it inside the struct:
+//
+//  struct State {
+//      double height_;
+//      double velocity_;
+//      FMU4CPP_REFLECT(State, height_, velocity_)
+//  };
+#define FMU4CPP_REFLECT(Type, ...)                                                                       \
+    static constexpr const char *fmu4cpp_field_names() {                                                 \
+        return #__VA_ARGS__;                                                                             \
+    }                                                                                                    \
+    template<typename F>                                                                                 \
+    void fmu4cpp_visit_fields(F &&f) {                                                                   \
+        static_assert(std::is_trivially_copyable_v<Type>, "Reflected types must be trivially copyable"); \
+        f(__VA_ARGS__);                                                                                  \
+    }
+
+namespace fmu4cpp::reflect {
+
+    // Splits the stringified field list of FMU4CPP_REFLECT into variable names.
+    // A single trailing underscore, as commonly used for members, is dropped.
+    // Throws std::invalid_argument on an empty entry, e.g. a stray comma.
+    inline std::vector<std::string> field_names(std::string_view list) {
+        std::vector<std::string> names;
+        const auto all = list;
+        while (!list.empty()) {
+            const auto comma = list.find(',');
+            auto name = list.substr(0, comma);
+            list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+
+            const auto first = name.find_first_not_of(" \t\n");
+            if (first == std::string_view::npos || (comma != std::string_view::npos && list.empty())) {
+                throw std::invalid_argument("Empty field name in FMU4CPP_REFLECT list '" + std::string(all) + "'");
+            }
+            const auto last = name.find_last_not_of(" \t\n");
+            name = name.substr(first, last - first + 1);
+            if (name.size() > 1 && name.back() == '_') {
+                name.remove_suffix(1);
+            }
+            names.emplace_back(name);
+        }
+        return names;
+    }
+
+    template<typename T>
+    struct always_false : std::false_type {};
+
+}// namespace fmu4cpp::reflect
+
+#endif//FMU4CPP_REFLECT_HPP
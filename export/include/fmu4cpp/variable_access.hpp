@@ -8,6 +8,12 @@
 
 namespace fmu4cpp {
 
+    // Accessors bound at compile time, invoked with the model instance as context. See fmu_base::register_real<Getter, Setter>.
+    template<typename T>
+    using bound_getter = T (*)(void *);
+    template<typename T>
+    using bound_setter = void (*)(void *, T);
+
     template<typename T>
     struct VariableAccess {
         virtual T get() = 0;
@@ -16,27 +22,6 @@ namespace fmu4cpp {
         virtual ~VariableAccess() = default;
     };
 
-    template<typename T>
-    class PtrAccess final : public VariableAccess<T> {
-
-    public:
-        explicit PtrAccess(T *ptr, const std::function<void()>& onChange)
-        : ptr_(ptr), onChange_(onChange) {}
-
-        T get() override {
-            return *ptr_;
-        }
-
-        void set(T value) override {
-            *ptr_ = value;
-            if (onChange_) onChange_();
-        }
-
-    private:
-        T *ptr_;
-        std::function<void()> onChange_;
-    };
-
     template<typename T>
     class LambdaAccess final : public VariableAccess<T> {
 
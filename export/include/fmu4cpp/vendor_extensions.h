@@ -0,0 +1,131 @@
+#ifndef FMU4CPP_VENDOR_EXTENSIONS_H
+#define FMU4CPP_VENDOR_EXTENSIONS_H
+
+/*
+  fmu4cpp specific entry points exported next to the standard FMI functions.
+  Importers discover them through the fmu4cpp tool annotation in modelDescription.xml
+  and load them by name. The instance argument is the fmi2Component/fmi3Instance.
+
+  Booleans are C bool in both wrappers, which matches fmi3Boolean but NOT fmi2Boolean (an int).
+  FMI 2.0 importers have to convert to and from bool buffers instead of passing fmi2Boolean arrays.
+*/
+
+#include "fmu4cpp/status.hpp"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if !defined(FMU4CPP_Export)
+#if defined _WIN32 || defined __CYGWIN__
+#define FMU4CPP_Export __declspec(dllexport)
+#else
+#if __GNUC__ >= 4
+#define FMU4CPP_Export __attribute__((visibility("default")))
+#else
+#define FMU4CPP_Export
+#endif
+#endif
+#endif
+
+typedef void *fmu4cppAccessPlan;
+
+/* Resolves and validates a list of value references of a single type (Integer, Real or Boolean) once.
+   Returns NULL on failure. The plan is owned by the instance and is released with fmu4cppFreeAccess,
+   or when the instance is freed. */
+FMU4CPP_Export fmu4cppAccessPlan fmu4cppPrepareAccess(void *instance, const unsigned int vr[], size_t nvr);
+FMU4CPP_Export void fmu4cppFreeAccess(fmu4cppAccessPlan plan);
+
+FMU4CPP_Export fmiStatus fmu4cppGetIntegerPrepared(fmu4cppAccessPlan plan, int values[]);
+FMU4CPP_Export fmiStatus fmu4cppGetRealPrepared(fmu4cppAccessPlan plan, double values[]);
+/* bool, also with FMI 2.0, see above */
+FMU4CPP_Export fmiStatus fmu4cppGetBooleanPrepared(fmu4cppAccessPlan plan, bool values[]);
+
+FMU4CPP_Export fmiStatus fmu4cppSetIntegerPrepared(fmu4cppAccessPlan plan, const int values[]);
+FMU4CPP_Export fmiStatus fmu4cppSetRealPrepared(fmu4cppAccessPlan plan, const double values[]);
+FMU4CPP_Export fmiStatus fmu4cppSetBooleanPrepared(fmu4cppAccessPlan plan, const bool values[]);
+
+/* Writes the value references of the outputs that changed since *token was handed out, and updates *token.
+   Pass a token of 0 on the first call to receive all outputs. If more than `capacity` outputs changed,
+   *nvr is set to the required capacity, *token is left untouched and fmiDiscard is returned. */
+FMU4CPP_Export fmiStatus fmu4cppGetChangedOutputs(void *instance, uint64_t *token,
+                                                  unsigned int vr[], size_t capacity, size_t *nvr);
+
+/* Invoked at the end of every successful step with the outputs that changed during that step.
+   Pass NULL to remove the callback. */
+typedef void (*fmu4cppOutputsChangedCallback)(void *environment, const unsigned int vr[], size_t nvr);
+FMU4CPP_Export fmiStatus fmu4cppSetOutputsChangedCallback(void *instance, fmu4cppOutputsChangedCallback callback,
+                                                          void *environment);
+
+/* Publishes time and the Integer, Real and Boolean outputs at the end of every step from now on. */
+FMU4CPP_Export fmiStatus fmu4cppEnableOutputSnapshot(void *instance);
+
+/* Reads values from the last published snapshot. May be called from any thread, also during fmi*DoStep,
+   and never blocks it. Integers and Booleans are returned as doubles. time may be NULL.
+   Returns fmiError without logging if a value reference is not an output or snapshots are not enabled. */
+FMU4CPP_Export fmiStatus fmu4cppReadOutputSnapshot(void *instance, const unsigned int vr[], size_t nvr,
+                                                   double values[], double *time);
+
+/* Typed value references and values exchanged by fmu4cppExchangeStep, one value per value reference.
+   The pointers of a type may be NULL if its count is 0. */
+typedef struct {
+    const unsigned int *realVr;
+    size_t nReal;
+    double *realValues;
+
+    const unsigned int *integerVr;
+    size_t nInteger;
+    int *integerValues;
+
+    const unsigned int *booleanVr;
+    size_t nBoolean;
+    bool *booleanValues;// bool, also with FMI 2.0, see above
+
+    const unsigned int *stringVr;
+    size_t nString;
+    const char **stringValues;
+} fmu4cppStepValues;
+
+/* Sets the inputs, steps from currentTime by stepSize as fmi*DoStep does, and reads the outputs, all in one call.
+   inputs, outputs and the remaining out-parameters may be NULL. *lastSuccessfulTime is set to the time the step reached,
+   which is earlier than currentTime + stepSize if the step returned early (*earlyReturn, FMI3 only).
+   *eventHandlingNeeded tells that the step stopped at an event, with FMI3 event mode in use. Both are false with FMI2.
+   If the model rejects the step, fmiDiscard is returned, *lastSuccessfulTime is left at the last successful step
+   and the outputs are still read. With FMI2 the model then asks to terminate, see fmi2GetBooleanStatus(fmi2Terminated).
+   String outputs stay valid until the next call into the instance. */
+FMU4CPP_Export fmiStatus fmu4cppExchangeStep(void *instance, const fmu4cppStepValues *inputs,
+                                             double currentTime, double stepSize, fmu4cppStepValues *outputs,
+                                             double *lastSuccessfulTime, bool *earlyReturn, bool *eventHandlingNeeded);
+
+/* Real inputs and outputs of fmu4cppDoSteps. Before step k, inputVr[i] is set to inputValues[k * inputStride + i],
+   where an inputStride of 0 holds the inputs constant. After step k, outputVr[i] is read into
+   outputValues[k * outputStride + i]. Either side may be empty. The value references have to be usable with
+   fmu4cppPrepareAccess, as they are resolved once for the whole series. */
+typedef struct {
+    const unsigned int *inputVr;
+    size_t nInputs;
+    const double *inputValues;
+    size_t inputStride;
+
+    const unsigned int *outputVr;
+    size_t nOutputs;
+    double *outputValues;
+    size_t outputStride;
+} fmu4cppStepSeries;
+
+/* Takes nSteps steps of stepSize from currentTime, as that many calls of fmi*DoStep would, in one call.
+   series and lastSuccessfulTime may be NULL. *nCompleted is set to the number of steps that completed, and their
+   outputs are recorded. If the model rejects a step, the series ends there and fmiDiscard is returned.
+   With FMI3, the series also ends after a step that returns early or needs event handling. */
+FMU4CPP_Export fmiStatus fmu4cppDoSteps(void *instance, double currentTime, double stepSize, size_t nSteps,
+                                        const fmu4cppStepSeries *series, size_t *nCompleted, double *lastSuccessfulTime);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//FMU4CPP_VENDOR_EXTENSIONS_H
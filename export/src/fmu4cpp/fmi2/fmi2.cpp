@@ -1,15 +1,19 @@
 
 #include "fmi2Functions.h"
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "fmu4cpp/fmu_base.hpp"
 #include "fmu4cpp/fmu_except.hpp"
 #include "fmu4cpp/logger.hpp"
+#include "fmu4cpp/util.hpp"
+#include "fmu4cpp/vendor_extensions.h"
 
 namespace {
 
@@ -46,9 +50,27 @@ namespace {
         const fmi2CallbackFunctions *f_;
     };
 
+    struct Fmi2Component;
+
+    // A prepared access plan handed out through the fmu4cpp vendor extensions.
+    struct Fmi2AccessPlan {
+        Fmi2Component *component;
+        fmu4cpp::fmu_base::access_plan plan;
+    };
+
     // A struct that holds all the data for one model instance.
     struct Fmi2Component {
 
+        // Tracked for the Model Exchange functions, which are only valid in some of the states
+        enum class State {
+            Instantiated = 1 << 0,
+            InitializationMode = 1 << 1,
+            StepMode = 1 << 2,
+            Terminated = 1 << 3,
+            EventMode = 1 << 4,
+            ContinuousTimeMode = 1 << 5
+        };
+
         Fmi2Component(std::unique_ptr<fmu4cpp::fmu_base> slave, std::unique_ptr<fmi2Logger> logger)
             : lastSuccessfulTime{std::numeric_limits<double>::quiet_NaN()},
               slave(std::move(slave)),
@@ -56,6 +78,8 @@ namespace {
 
         double lastSuccessfulTime{0};
         bool wantsToTerminate{false};
+        bool modelExchange{false};
+        State state{State::Instantiated};
 
         std::unique_ptr<fmu4cpp::fmu_base> slave;
         std::unique_ptr<fmi2Logger> logger;
@@ -63,8 +87,61 @@ namespace {
         double start{0};
         std::optional<double> stop;
         std::optional<double> tolerance;
+
+        std::vector<std::unique_ptr<Fmi2AccessPlan>> accessPlans;
+        std::vector<unsigned int> changedOutputs;
     };
 
+
+    template<typename F>
+    fmiStatus invokePrepared(fmu4cppAccessPlan p, F &&f) {
+        const auto plan = static_cast<Fmi2AccessPlan *>(p);
+        const auto component = plan->component;
+        try {
+            f(*component->slave, plan->plan);
+            return fmiOK;
+        } catch (const fmu4cpp::fatal_error &ex) {
+            component->logger->log(fmiFatal, ex.what());
+            return fmiFatal;
+        } catch (const std::exception &ex) {
+            component->logger->log(fmiError, ex.what());
+            return fmiError;
+        }
+    }
+
+    // Throws unless the instance is in one of the allowed states, a combination of Fmi2Component::State flags
+    void requireState(const Fmi2Component &component, int allowed, const char *expected) {
+        if (!(static_cast<int>(component.state) & allowed)) {
+            throw std::logic_error(std::string("Invalid state. Expected ") + expected + ".");
+        }
+    }
+
+    // The states and derivatives can be read once initialisation has started
+    constexpr int STATES_READABLE = static_cast<int>(Fmi2Component::State::InitializationMode) |
+                                    static_cast<int>(Fmi2Component::State::EventMode) |
+                                    static_cast<int>(Fmi2Component::State::ContinuousTimeMode) |
+                                    static_cast<int>(Fmi2Component::State::Terminated);
+    constexpr const char *STATES_READABLE_NAMES = "InitializationMode, EventMode, ContinuousTimeMode or Terminated";
+
+    // The Model Exchange functions, which are only available to instances created for Model Exchange
+    template<typename F>
+    fmi2Status invokeModelExchange(fmi2Component c, F &&f) {
+        const auto component = static_cast<Fmi2Component *>(c);
+        try {
+            if (!component->modelExchange) {
+                throw std::logic_error("Not instantiated for Model Exchange.");
+            }
+            f(*component);
+            return fmi2OK;
+        } catch (const fmu4cpp::fatal_error &ex) {
+            component->logger->log(fmiFatal, ex.what());
+            return fmi2Fatal;
+        } catch (const std::exception &ex) {
+            component->logger->log(fmiError, ex.what());
+            return fmi2Error;
+        }
+    }
+
 }// namespace
 
 extern "C" {
@@ -96,7 +173,7 @@ fmi2Component fmi2Instantiate(fmi2String instanceName,
     auto logger = std::make_unique<fmi2Logger>(instanceName, functions);
     logger->setDebugLogging(loggingOn);
 
-    if (fmuType != fmi2CoSimulation) {
+    if (fmuType != fmi2CoSimulation && fmuType != fmi2ModelExchange) {
         logger->log(fmiFatal, "[fmu4cpp] Error. Unsupported fmuType!");
         return nullptr;
     }
@@ -130,9 +207,17 @@ fmi2Component fmi2Instantiate(fmi2String instanceName,
         logger->log(fmiFatal, "[fmu4cpp] Error. Wrong guid!");
         return nullptr;
     }
+    if (fmuType == fmi2ModelExchange && !slave->provides_model_exchange()) {
+        logger->log(fmiFatal, "[fmu4cpp] Error. Model Exchange is not provided by this model!");
+        return nullptr;
+    }
 
     try {
         auto c = std::make_unique<Fmi2Component>(std::move(slave), std::move(logger));
+        if (fmuType == fmi2ModelExchange) {
+            c->slave->enable_model_exchange();
+            c->modelExchange = true;
+        }
 
         return c.release();
     } catch (const std::exception &e) {
@@ -169,6 +254,7 @@ fmi2Status fmi2EnterInitializationMode(fmi2Component c) {
 
     try {
         component->slave->enter_initialisation_mode(component->start, component->stop, component->tolerance);
+        component->state = Fmi2Component::State::InitializationMode;
         return fmi2OK;
     } catch (const fmu4cpp::fatal_error &ex) {
         component->logger->log(fmiFatal, ex.what());
@@ -182,7 +268,8 @@ fmi2Status fmi2EnterInitializationMode(fmi2Component c) {
 fmi2Status fmi2ExitInitializationMode(fmi2Component c) {
     const auto component = static_cast<Fmi2Component *>(c);
     try {
-        component->slave->exit_initialisation_mode();
+        component->slave->finish_initialisation();
+        component->state = component->modelExchange ? Fmi2Component::State::EventMode : Fmi2Component::State::StepMode;
         return fmi2OK;
     } catch (const fmu4cpp::fatal_error &ex) {
         component->logger->log(fmiFatal, ex.what());
@@ -197,6 +284,7 @@ fmi2Status fmi2Terminate(fmi2Component c) {
     const auto component = static_cast<Fmi2Component *>(c);
     try {
         component->slave->terminate();
+        component->state = Fmi2Component::State::Terminated;
         return fmi2OK;
     } catch (const fmu4cpp::fatal_error &ex) {
         component->logger->log(fmiFatal, ex.what());
@@ -215,6 +303,9 @@ fmi2Status fmi2DoStep(
 
     const auto component = static_cast<Fmi2Component *>(c);
     try {
+        if (component->modelExchange) {
+            throw std::logic_error("Not available for Model Exchange.");
+        }
         if (component->slave->step(currentCommunicationPoint, communicationStepSize)) {
             component->lastSuccessfulTime = currentCommunicationPoint + communicationStepSize;
             return fmi2OK;
@@ -236,7 +327,8 @@ fmi2Status fmi2CancelStep(fmi2Component) {
 
 fmi2Status fmi2Reset(fmi2Component c) {
     const auto component = static_cast<Fmi2Component *>(c);
-    component->slave->reset();
+    component->slave->reset_instance();
+    component->state = Fmi2Component::State::Instantiated;
     return fmi2OK;
 }
 
@@ -479,6 +571,89 @@ fmi2Status fmi2GetDirectionalDerivative(fmi2Component,
 }
 
 
+fmi2Status fmi2EnterEventMode(fmi2Component c) {
+    return invokeModelExchange(c, [](Fmi2Component &component) {
+        requireState(component, static_cast<int>(Fmi2Component::State::ContinuousTimeMode), "ContinuousTimeMode");
+        component.state = Fmi2Component::State::EventMode;
+    });
+}
+
+fmi2Status fmi2NewDiscreteStates(fmi2Component c, fmi2EventInfo *eventInfo) {
+    return invokeModelExchange(c, [eventInfo](Fmi2Component &component) {
+        requireState(component, static_cast<int>(Fmi2Component::State::EventMode), "EventMode");
+        const auto update = component.slave->update_discrete_states();
+        eventInfo->newDiscreteStatesNeeded = update.needsUpdate;
+        eventInfo->terminateSimulation = false;
+        eventInfo->nominalsOfContinuousStatesChanged = false;
+        eventInfo->valuesOfContinuousStatesChanged = false;
+        eventInfo->nextEventTimeDefined = update.nextEventTime.has_value();
+        eventInfo->nextEventTime = update.nextEventTime.value_or(0);
+    });
+}
+
+fmi2Status fmi2EnterContinuousTimeMode(fmi2Component c) {
+    return invokeModelExchange(c, [](Fmi2Component &component) {
+        requireState(component, static_cast<int>(Fmi2Component::State::EventMode), "EventMode");
+        component.state = Fmi2Component::State::ContinuousTimeMode;
+    });
+}
+
+fmi2Status fmi2CompletedIntegratorStep(fmi2Component c,
+                                       fmi2Boolean /*noSetFMUStatePriorToCurrentPoint*/,
+                                       fmi2Boolean *enterEventMode,
+                                       fmi2Boolean *terminateSimulation) {
+    return invokeModelExchange(c, [enterEventMode, terminateSimulation](Fmi2Component &component) {
+        requireState(component, static_cast<int>(Fmi2Component::State::ContinuousTimeMode), "ContinuousTimeMode");
+        *enterEventMode = component.slave->event_pending();
+        *terminateSimulation = false;
+    });
+}
+
+fmi2Status fmi2SetTime(fmi2Component c, fmi2Real time) {
+    return invokeModelExchange(c, [time](Fmi2Component &component) {
+        requireState(component,
+                     static_cast<int>(Fmi2Component::State::EventMode) | static_cast<int>(Fmi2Component::State::ContinuousTimeMode),
+                     "EventMode or ContinuousTimeMode");
+        component.slave->set_time(time);
+    });
+}
+
+fmi2Status fmi2SetContinuousStates(fmi2Component c, const fmi2Real x[], size_t nx) {
+    return invokeModelExchange(c, [x, nx](Fmi2Component &component) {
+        requireState(component, static_cast<int>(Fmi2Component::State::ContinuousTimeMode), "ContinuousTimeMode");
+        component.slave->set_continuous_states(x, nx);
+    });
+}
+
+fmi2Status fmi2GetDerivatives(fmi2Component c, fmi2Real derivatives[], size_t nx) {
+    return invokeModelExchange(c, [derivatives, nx](Fmi2Component &component) {
+        requireState(component, STATES_READABLE, STATES_READABLE_NAMES);
+        component.slave->get_derivatives(derivatives, nx);
+    });
+}
+
+// fmu4cpp models have no event indicators
+fmi2Status fmi2GetEventIndicators(fmi2Component c, fmi2Real[], size_t ni) {
+    return invokeModelExchange(c, [ni](Fmi2Component &) {
+        if (ni != 0) throw std::invalid_argument("Expected 0 event indicators");
+    });
+}
+
+fmi2Status fmi2GetContinuousStates(fmi2Component c, fmi2Real x[], size_t nx) {
+    return invokeModelExchange(c, [x, nx](Fmi2Component &component) {
+        requireState(component, STATES_READABLE, STATES_READABLE_NAMES);
+        component.slave->get_continuous_states(x, nx);
+    });
+}
+
+fmi2Status fmi2GetNominalsOfContinuousStates(fmi2Component c, fmi2Real nominals[], size_t nx) {
+    return invokeModelExchange(c, [nominals, nx](Fmi2Component &component) {
+        requireState(component, STATES_READABLE, STATES_READABLE_NAMES);
+        if (nx != component.slave->number_of_continuous_states()) throw std::invalid_argument("Wrong number of continuous states");
+        std::fill(nominals, nominals + nx, 1.0);
+    });
+}
+
 fmi2Status fmi2GetFMUstate(fmi2Component c, fmi2FMUstate *state) {
 
     const auto component = static_cast<Fmi2Component *>(c);
@@ -603,4 +778,176 @@ void fmi2FreeInstance(fmi2Component c) {
         c = nullptr;
     }
 }
+
+fmu4cppAccessPlan fmu4cppPrepareAccess(void *instance, const unsigned int vr[], size_t nvr) {
+    const auto component = static_cast<Fmi2Component *>(instance);
+    try {
+        auto plan = std::make_unique<Fmi2AccessPlan>();
+        plan->component = component;
+        plan->plan = component->slave->prepare_access(vr, nvr);
+        return component->accessPlans.emplace_back(std::move(plan)).get();
+    } catch (const std::exception &ex) {
+        component->logger->log(fmiError, ex.what());
+        return nullptr;
+    }
+}
+
+void fmu4cppFreeAccess(fmu4cppAccessPlan p) {
+    if (p) {
+        const auto plan = static_cast<Fmi2AccessPlan *>(p);
+        auto &plans = plan->component->accessPlans;
+        plans.erase(std::remove_if(plans.begin(), plans.end(), [plan](const auto &it) {
+                        return it.get() == plan;
+                    }),
+                    plans.end());
+    }
+}
+
+fmiStatus fmu4cppGetIntegerPrepared(fmu4cppAccessPlan plan, int values[]) {
+    return invokePrepared(plan, [values](auto &slave, const auto &p) { slave.get_integer(p, values); });
+}
+
+fmiStatus fmu4cppGetRealPrepared(fmu4cppAccessPlan plan, double values[]) {
+    return invokePrepared(plan, [values](auto &slave, const auto &p) { slave.get_real(p, values); });
+}
+
+fmiStatus fmu4cppGetBooleanPrepared(fmu4cppAccessPlan plan, bool values[]) {
+    return invokePrepared(plan, [values](auto &slave, const auto &p) { slave.get_boolean(p, values); });
+}
+
+fmiStatus fmu4cppSetIntegerPrepared(fmu4cppAccessPlan plan, const int values[]) {
+    return invokePrepared(plan, [values](auto &slave, const auto &p) { slave.set_integer(p, values); });
+}
+
+fmiStatus fmu4cppSetRealPrepared(fmu4cppAccessPlan plan, const double values[]) {
+    return invokePrepared(plan, [values](auto &slave, const auto &p) { slave.set_real(p, values); });
+}
+
+fmiStatus fmu4cppSetBooleanPrepared(fmu4cppAccessPlan plan, const bool values[]) {
+    return invokePrepared(plan, [values](auto &slave, const auto &p) { slave.set_boolean(p, values); });
+}
+
+fmiStatus fmu4cppGetChangedOutputs(void *instance, uint64_t *token, unsigned int vr[], size_t capacity, size_t *nvr) {
+    const auto component = static_cast<Fmi2Component *>(instance);
+    try {
+        auto &changed = component->changedOutputs;
+        changed.clear();
+        const auto next = component->slave->changed_outputs(*token, changed);
+        *nvr = changed.size();
+        if (changed.size() > capacity) {
+            return fmiDiscard;
+        }
+        std::copy(changed.begin(), changed.end(), vr);
+        *token = next;
+        return fmiOK;
+    } catch (const fmu4cpp::fatal_error &ex) {
+        component->logger->log(fmiFatal, ex.what());
+        return fmiFatal;
+    } catch (const std::exception &ex) {
+        component->logger->log(fmiError, ex.what());
+        return fmiError;
+    }
+}
+
+fmiStatus fmu4cppSetOutputsChangedCallback(void *instance, fmu4cppOutputsChangedCallback callback, void *environment) {
+    const auto component = static_cast<Fmi2Component *>(instance);
+    if (callback) {
+        component->slave->set_outputs_changed_callback([callback, environment](const unsigned int vr[], size_t nvr) {
+            callback(environment, vr, nvr);
+        });
+    } else {
+        component->slave->set_outputs_changed_callback(nullptr);
+    }
+    return fmiOK;
+}
+
+fmiStatus fmu4cppEnableOutputSnapshot(void *instance) {
+    const auto component = static_cast<Fmi2Component *>(instance);
+    try {
+        component->slave->enable_output_snapshot();
+        return fmiOK;
+    } catch (const fmu4cpp::fatal_error &ex) {
+        component->logger->log(fmiFatal, ex.what());
+        return fmiFatal;
+    } catch (const std::exception &ex) {
+        component->logger->log(fmiError, ex.what());
+        return fmiError;
+    }
+}
+
+fmiStatus fmu4cppReadOutputSnapshot(void *instance, const unsigned int vr[], size_t nvr, double values[], double *time) {
+    // called from other threads, so neither logging nor touching the component state
+    const auto component = static_cast<const Fmi2Component *>(instance);
+    return component->slave->read_output_snapshot(vr, nvr, values, time) ? fmiOK : fmiError;
+}
+
+fmiStatus fmu4cppExchangeStep(void *instance, const fmu4cppStepValues *inputs,
+                              double currentTime, double stepSize, fmu4cppStepValues *outputs,
+                              double *lastSuccessfulTime, bool *earlyReturn, bool *eventHandlingNeeded) {
+    const auto component = static_cast<Fmi2Component *>(instance);
+    try {
+        if (component->modelExchange) {
+            throw std::logic_error("Not available for Model Exchange.");
+        }
+        auto &slave = *component->slave;
+        if (inputs) fmu4cpp::set_step_inputs(slave, *inputs);
+
+        auto status = fmiOK;
+        if (slave.step(currentTime, stepSize)) {
+            component->lastSuccessfulTime = currentTime + stepSize;
+        } else {
+            component->wantsToTerminate = true;
+            status = fmiDiscard;
+        }
+        if (lastSuccessfulTime) *lastSuccessfulTime = component->lastSuccessfulTime;
+        // neither exists in FMI2
+        if (earlyReturn) *earlyReturn = false;
+        if (eventHandlingNeeded) *eventHandlingNeeded = false;
+
+        if (outputs) fmu4cpp::get_step_outputs(slave, *outputs);
+        return status;
+    } catch (const fmu4cpp::fatal_error &ex) {
+        component->logger->log(fmiFatal, ex.what());
+        return fmiFatal;
+    } catch (const std::exception &ex) {
+        component->logger->log(fmiError, ex.what());
+        return fmiError;
+    }
+}
+
+fmiStatus fmu4cppDoSteps(void *instance, double currentTime, double stepSize, size_t nSteps,
+                         const fmu4cppStepSeries *series, size_t *nCompleted, double *lastSuccessfulTime) {
+    const auto component = static_cast<Fmi2Component *>(instance);
+    *nCompleted = 0;
+    double time = currentTime;
+    auto status = fmiOK;
+    try {
+        if (component->modelExchange) {
+            throw std::logic_error("Not available for Model Exchange.");
+        }
+        auto &slave = *component->slave;
+        const fmu4cpp::step_series steps(slave, series, nSteps);
+
+        for (size_t k = 0; k < nSteps; k++) {
+            steps.set_inputs(slave, k);
+            if (!slave.step(time, stepSize)) {
+                component->wantsToTerminate = true;
+                status = fmiDiscard;
+                break;
+            }
+            time += stepSize;// as fmu_base advances its own time
+            component->lastSuccessfulTime = time;
+            steps.get_outputs(slave, k);
+            ++*nCompleted;
+        }
+    } catch (const fmu4cpp::fatal_error &ex) {
+        component->logger->log(fmiFatal, ex.what());
+        status = fmiFatal;
+    } catch (const std::exception &ex) {
+        component->logger->log(fmiError, ex.what());
+        status = fmiError;
+    }
+    if (lastSuccessfulTime) *lastSuccessfulTime = time;
+    return status;
+}
 }
@@ -23,11 +23,25 @@ std::string fmu_base::make_description() const {
        << "\tgenerationDateAndTime=\"" << now() << "\"\n"
        << "\tdescription=\"" << m.description << "\"\n"
        << "\tauthor=\"" << m.author << "\"\n"
-       << "\tvariableNamingConvention=\"" << m.variableNamingConvention << "\""
-       << ">\n\n";
-
-    ss << std::boolalpha
-       << "\t<CoSimulation\n"
+       << "\tvariableNamingConvention=\"" << m.variableNamingConvention << "\"";
+    if (provides_model_exchange()) {
+        ss << "\n\tnumberOfEventIndicators=\"0\"";
+    }
+    ss << ">\n\n";
+
+    ss << std::boolalpha;
+    if (provides_model_exchange()) {
+        ss << "\t<ModelExchange\n"
+           << "\t\tneedsExecutionTool=\"" << m.needsExecutionTool << "\"\n"
+           << "\t\tmodelIdentifier=\"" << model_identifier() << "\"\n"
+           << "\t\tcanBeInstantiatedOnlyOncePerProcess=\"" << m.canBeInstantiatedOnlyOncePerProcess << "\"\n"
+           << "\t\tcanGetAndSetFMUstate=\"" << m.canGetAndSetFMUstate << "\"\n"
+           << "\t\tcanSerializeFMUstate=\"" << m.canSerializeFMUstate << "\"\n"
+           << "\t\tcanNotUseMemoryManagementFunctions=\"true\""
+           << ">\n"
+           << "\t</ModelExchange>\n\n";
+    }
+    ss << "\t<CoSimulation\n"
        << "\t\tneedsExecutionTool=\"" << m.needsExecutionTool << "\"\n"
        << "\t\tmodelIdentifier=\"" << model_identifier() << "\"\n"
        << "\t\tcanHandleVariableCommunicationStepSize=\"" << m.canHandleVariableCommunicationStepSize << "\"\n"
@@ -49,19 +63,21 @@ std::string fmu_base::make_description() const {
         ss << "/>\n\n";
     }
 
-    if (!m.vendorAnnotations.empty()) {
-        ss << "\t<VendorAnnotations>\n";
-        for (const auto &annotation: m.vendorAnnotations) {
-            std::string indentedAnnotation = indent_multiline_string(annotation, 2);
-            ss << indentedAnnotation << "\n";
-        }
-        ss << "\t</VendorAnnotations>\n\n";
+    ss << "\t<VendorAnnotations>\n";
+    ss << indent_multiline_string(vendor_tool_annotation(), 2) << "\n";
+    for (const auto &annotation: m.vendorAnnotations) {
+        std::string indentedAnnotation = indent_multiline_string(annotation, 2);
+        ss << indentedAnnotation << "\n";
     }
+    ss << "\t</VendorAnnotations>\n\n";
 
     ss << "\t<ModelVariables>\n";
 
+    // Real ranges have no variables of their own, their elements only exist while the description is written
+    const auto rangeElements = range_elements();
     const auto allVars = [&] {
         auto allVars = collect(integers_, reals_, booleans_, strings_);
+        collect_ranges(allVars, rangeElements);
         std::sort(allVars.begin(), allVars.end(), [](const VariableBase *v1, const VariableBase *v2) {
             return v1->index() < v2->index();
         });
@@ -116,6 +132,9 @@ std::string fmu_base::make_description() const {
             if (const auto unit = r->getUnit()) {
                 ss << " unit=\"" << *unit << "\"";
             }
+            if (const auto state = r->getDerivative()) {
+                ss << " derivative=\"" << *state + 1 << "\"";// the index, as value references follow registration
+            }
 
         } else if (auto s = dynamic_cast<const StringVariable *>(v)) {
             ss << "\t\t\t<String";
@@ -147,9 +166,11 @@ std::string fmu_base::make_description() const {
 
     ss << "\t<ModelStructure>\n";
 
-    const auto unknowns = collect(integers_, reals_, booleans_, strings_, [](auto &v) {
+    const auto isOutput = [](const VariableBase &v) {
         return v.causality() == causality_t::OUTPUT;
-    });
+    };
+    auto unknowns = collect(integers_, reals_, booleans_, strings_, isOutput);
+    collect_ranges(unknowns, rangeElements, isOutput);
 
     if (!unknowns.empty()) {
         ss << "\t\t<Outputs>\n";
@@ -177,9 +198,21 @@ std::string fmu_base::make_description() const {
         ss << "\t\t</Outputs>\n";
     }
 
-    const auto initialUnknowns = collect(integers_, reals_, booleans_, strings_, [](auto &v) {
+    if (provides_model_exchange()) {
+        ss << "\t\t<Derivatives>\n";
+        for (const auto &v: rangeElements) {
+            if (v.getDerivative()) {
+                ss << "\t\t\t<Unknown index=\"" << v.index() << "\"/>\n";
+            }
+        }
+        ss << "\t\t</Derivatives>\n";
+    }
+
+    const auto isInitialUnknown = [](const VariableBase &v) {
         return (v.causality() == causality_t::OUTPUT && v.initial() == initial_t::APPROX || v.initial() == initial_t::CALCULATED) || v.causality() == causality_t::CALCULATED_PARAMETER;
-    });
+    };
+    auto initialUnknowns = collect(integers_, reals_, booleans_, strings_, isInitialUnknown);
+    collect_ranges(initialUnknowns, rangeElements, isInitialUnknown);
     if (!initialUnknowns.empty()) {
         ss << "\t\t<InitialUnknowns>\n";
         for (const auto &v: initialUnknowns) {
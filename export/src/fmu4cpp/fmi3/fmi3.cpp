@@ -1,15 +1,19 @@
 
 #include "fmi3Functions.h"
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "fmu4cpp/fmu_base.hpp"
 #include "fmu4cpp/fmu_except.hpp"
 #include "fmu4cpp/logger.hpp"
+#include "fmu4cpp/vendor_extensions.h"
+#include "fmu4cpp/util.hpp"
 #include "fmu4cpp/status.hpp"
 
 namespace {
@@ -48,6 +52,14 @@ namespace {
         fmi3LogMessageCallback logCallback_;
     };
 
+    struct Fmi3Component;
+
+    // A prepared access plan handed out through the fmu4cpp vendor extensions.
+    struct Fmi3AccessPlan {
+        Fmi3Component *component;
+        fmu4cpp::fmu_base::access_plan plan;
+    };
+
     // A struct that holds all the data for one model instance.
     struct Fmi3Component {
 
@@ -56,7 +68,9 @@ namespace {
             InitializationMode = 1 << 1,
             StepMode = 1 << 2,
             Terminated = 1 << 3,
-            Invalid = 1 << 4
+            Invalid = 1 << 4,
+            EventMode = 1 << 5,
+            ContinuousTimeMode = 1 << 6
         };
 
         Fmi3Component(std::unique_ptr<fmu4cpp::fmu_base> slave, std::unique_ptr<fmi3Logger> logger)
@@ -65,34 +79,158 @@ namespace {
               logger(std::move(logger)) {}
 
         State state;
+        bool eventModeUsed{false};
+        bool modelExchange{false};
         std::unique_ptr<fmu4cpp::fmu_base> slave;
         std::unique_ptr<fmi3Logger> logger;
+
+        std::vector<std::unique_ptr<Fmi3AccessPlan>> accessPlans;
+        std::vector<unsigned int> changedOutputs;
     };
 
 #define FMU_TYPE(type) fmi3##type
 
-#define NOT_IMPLEMENTED_GETTER(type)                                                           \
-    fmi3Status fmi3Get##type(                                                                  \
-            fmi3Instance c,                                                                    \
-            const fmi3ValueReference vr[],                                                     \
-            size_t nValueReferences,                                                           \
-            FMU_TYPE(type) values[],                                                           \
-            size_t nValues) {                                                                  \
-        const auto component = static_cast<Fmi3Component *>(c);                                \
-        component->logger->log(fmiError, std::string("Unsupported function fmi3Get") + #type); \
-        return fmi3Error;                                                                      \
-    }
-
-#define NOT_IMPLEMENTED_SETTER(type)                                                           \
-    fmi3Status fmi3Set##type(                                                                  \
-            fmi3Instance c,                                                                    \
-            const fmi3ValueReference vr[],                                                     \
-            size_t nValueReferences,                                                           \
-            const FMU_TYPE(type) values[],                                                     \
-            size_t nValues) {                                                                  \
-        const auto component = static_cast<Fmi3Component *>(c);                                \
-        component->logger->log(fmiError, std::string("Unsupported function fmi3Set") + #type); \
-        return fmi3Error;                                                                      \
+#define NUMERIC_GETTER(type)                                                      \
+    fmi3Status fmi3Get##type(                                                     \
+            fmi3Instance c,                                                       \
+            const fmi3ValueReference vr[],                                        \
+            size_t nValueReferences,                                              \
+            FMU_TYPE(type) values[],                                              \
+            size_t nValues) {                                                     \
+        const auto component = static_cast<Fmi3Component *>(c);                   \
+        try {                                                                     \
+            component->slave->get_numeric(vr, nValueReferences, values, nValues); \
+            return fmi3OK;                                                        \
+        } catch (const fmu4cpp::fatal_error &ex) {                                \
+            component->logger->log(fmiFatal, ex.what());                          \
+            component->state = Fmi3Component::State::Invalid;                     \
+            return fmi3Fatal;                                                     \
+        } catch (const std::exception &ex) {                                      \
+            component->logger->log(fmiError, ex.what());                          \
+            component->state = Fmi3Component::State::Terminated;                  \
+            return fmi3Error;                                                     \
+        }                                                                         \
+    }
+
+#define NUMERIC_SETTER(type)                                                      \
+    fmi3Status fmi3Set##type(                                                     \
+            fmi3Instance c,                                                       \
+            const fmi3ValueReference vr[],                                        \
+            size_t nValueReferences,                                              \
+            const FMU_TYPE(type) values[],                                        \
+            size_t nValues) {                                                     \
+        const auto component = static_cast<Fmi3Component *>(c);                   \
+        try {                                                                     \
+            component->slave->set_numeric(vr, nValueReferences, values, nValues); \
+            return fmi3OK;                                                        \
+        } catch (const fmu4cpp::fatal_error &ex) {                                \
+            component->logger->log(fmiFatal, ex.what());                          \
+            component->state = Fmi3Component::State::Invalid;                     \
+            return fmi3Fatal;                                                     \
+        } catch (const std::exception &ex) {                                      \
+            component->logger->log(fmiError, ex.what());                          \
+            component->state = Fmi3Component::State::Terminated;                  \
+            return fmi3Error;                                                     \
+        }                                                                         \
+    }
+
+
+    template<typename F>
+    fmiStatus invokePrepared(fmu4cppAccessPlan p, F &&f) {
+        const auto plan = static_cast<Fmi3AccessPlan *>(p);
+        const auto component = plan->component;
+        try {
+            f(*component->slave, plan->plan);
+            return fmiOK;
+        } catch (const fmu4cpp::fatal_error &ex) {
+            component->logger->log(fmiFatal, ex.what());
+            component->state = Fmi3Component::State::Invalid;
+            return fmiFatal;
+        } catch (const std::exception &ex) {
+            component->logger->log(fmiError, ex.what());
+            component->state = Fmi3Component::State::Terminated;
+            return fmiError;
+        }
+    }
+
+    // The part of instantiation shared by Co-Simulation and Model Exchange. Returns nullptr, after logging why, on failure.
+    std::unique_ptr<Fmi3Component> instantiate(fmi3String instanceName,
+                                               fmi3String instantiationToken,
+                                               fmi3String resourcePath,
+                                               fmi3Boolean visible,
+                                               fmi3Boolean loggingOn,
+                                               fmi3InstanceEnvironment instanceEnvironment,
+                                               fmi3LogMessageCallback logMessage) {
+
+        int magic = 1;
+#ifdef _MSC_VER
+        magic = 0;
+#endif
+
+        std::string resources(resourcePath);
+
+        if (resources.find("file:////") != std::string::npos) {
+            resources.replace(0, 9 - magic, "");
+        } else if (resources.find("file:///") != std::string::npos) {
+            resources.replace(0, 8 - magic, "");
+        } else if (resources.find("file://") != std::string::npos) {
+            resources.replace(0, 7 - magic, "");
+        } else if (resources.find("file:/") != std::string::npos) {
+            resources.replace(0, 6 - magic, "");
+        }
+
+        auto logger = std::make_unique<fmi3Logger>(instanceEnvironment, logMessage, instanceName);
+        logger->setDebugLogging(loggingOn);
+
+        auto slave = fmu4cpp::createInstance(
+                {
+                        logger.get(),
+                        instanceName,
+                        resources,
+                        visible,
+                });
+        const auto guid = slave->guid();
+        if (guid != instantiationToken) {
+            logger->log(fmiFatal, "[fmu4cpp] Error. Wrong guid!");
+            return nullptr;
+        }
+
+        return std::make_unique<Fmi3Component>(std::move(slave), std::move(logger));
+    }
+
+    // Throws unless the instance is in one of the allowed states, a combination of Fmi3Component::State flags
+    void requireState(const Fmi3Component &component, int allowed, const char *expected) {
+        if (!(static_cast<int>(component.state) & allowed)) {
+            throw std::logic_error(std::string("Invalid state. Expected ") + expected + ".");
+        }
+    }
+
+    // The states and derivatives can be read once initialisation has started
+    constexpr int STATES_READABLE = static_cast<int>(Fmi3Component::State::InitializationMode) |
+                                    static_cast<int>(Fmi3Component::State::EventMode) |
+                                    static_cast<int>(Fmi3Component::State::ContinuousTimeMode) |
+                                    static_cast<int>(Fmi3Component::State::Terminated);
+    constexpr const char *STATES_READABLE_NAMES = "InitializationMode, EventMode, ContinuousTimeMode or Terminated";
+
+    // The Model Exchange functions, which are only available to instances created for Model Exchange
+    template<typename F>
+    fmi3Status invokeModelExchange(fmi3Instance c, F &&f) {
+        const auto component = static_cast<Fmi3Component *>(c);
+        try {
+            if (!component->modelExchange) {
+                throw std::logic_error("Not instantiated for Model Exchange.");
+            }
+            f(*component->slave);
+            return fmi3OK;
+        } catch (const fmu4cpp::fatal_error &ex) {
+            component->logger->log(fmiFatal, ex.what());
+            component->state = Fmi3Component::State::Invalid;
+            return fmi3Fatal;
+        } catch (const std::exception &ex) {
+            component->logger->log(fmiError, ex.what());
+            component->state = Fmi3Component::State::Terminated;
+            return fmi3Error;
+        }
     }
 
 }// namespace
@@ -119,9 +257,19 @@ fmi3Instance fmi3InstantiateModelExchange(fmi3String instanceName,
                                           fmi3InstanceEnvironment instanceEnvironment,
                                           fmi3LogMessageCallback logMessage) {
 
-    fmi3Logger l(instanceEnvironment, logMessage, instanceName);
-    l.log(fmiFatal, "[fmu4cpp] Unsupported mode: Model Exchange");
-    return nullptr;
+    auto c = instantiate(instanceName, instantiationToken, resourcePath, visible, loggingOn, instanceEnvironment, logMessage);
+    if (!c) return nullptr;
+
+    if (!c->slave->provides_model_exchange()) {
+        c->logger->log(fmiFatal, "[fmu4cpp] Unsupported mode: Model Exchange");
+        return nullptr;
+    }
+    c->slave->enable_model_exchange();
+    c->modelExchange = true;
+    c->eventModeUsed = true;// Model Exchange always goes through event mode
+    c->slave->set_event_mode_used(true);
+
+    return c.release();
 }
 
 fmi3Instance fmi3InstantiateScheduledExecution(
@@ -155,56 +303,55 @@ fmi3Instance fmi3InstantiateCoSimulation(
         fmi3LogMessageCallback logMessage,
         fmi3IntermediateUpdateCallback intermediateUpdate) {
 
-    int magic = 1;
-#ifdef _MSC_VER
-    magic = 0;
-#endif
-
-    std::string resources(resourcePath);
-
-    if (resources.find("file:////") != std::string::npos) {
-        resources.replace(0, 9 - magic, "");
-    } else if (resources.find("file:///") != std::string::npos) {
-        resources.replace(0, 8 - magic, "");
-    } else if (resources.find("file://") != std::string::npos) {
-        resources.replace(0, 7 - magic, "");
-    } else if (resources.find("file:/") != std::string::npos) {
-        resources.replace(0, 6 - magic, "");
-    }
-
-    auto logger = std::make_unique<fmi3Logger>(instanceEnvironment, logMessage, instanceName);
-    logger->setDebugLogging(loggingOn);
-
-    auto slave = fmu4cpp::createInstance(
-            {
-                    logger.get(),
-                    instanceName,
-                    resources,
-                    visible,
-            });
-    const auto guid = slave->guid();
-    if (guid != instantiationToken) {
-        logger->log(fmiFatal, "[fmu4cpp] Error. Wrong guid!");
-        return nullptr;
-    }
+    auto c = instantiate(instanceName, instantiationToken, resourcePath, visible, loggingOn, instanceEnvironment, logMessage);
+    if (!c) return nullptr;
 
     try {
-        auto c = std::make_unique<Fmi3Component>(std::move(slave), std::move(logger));
+        fmu4cpp::fmu_base::intermediate_update_callback callback;
+        if (intermediateUpdate) {
+            callback = [instanceEnvironment, intermediateUpdate](double time, bool canReturnEarly) -> std::optional<double> {
+                fmi3Boolean earlyReturnRequested = false;
+                fmi3Float64 earlyReturnTime = time;
+                // outputs may be read, but inputs are not taken during the step
+                intermediateUpdate(instanceEnvironment, time, false, true, true, canReturnEarly, &earlyReturnRequested, &earlyReturnTime);
+                if (earlyReturnRequested) return earlyReturnTime;
+                return std::nullopt;
+            };
+        }
+        c->eventModeUsed = eventModeUsed;
+        c->slave->set_event_mode_used(eventModeUsed);
+        c->slave->set_intermediate_update(
+                std::move(callback), earlyReturnAllowed,
+                {requiredIntermediateVariables, requiredIntermediateVariables + nRequiredIntermediateVariables});
 
         return c.release();
     } catch (const std::exception &e) {
 
-        logger->log(fmiFatal, "[fmu4cpp] Unable to instantiate model! " + std::string(e.what()));
+        c->logger->log(fmiFatal, "[fmu4cpp] Unable to instantiate model! " + std::string(e.what()));
 
         return nullptr;
     }
 }
 
-fmi3Status fmi3EnterEventMode(fmi3Instance instance) {
+fmi3Status fmi3EnterEventMode(fmi3Instance c) {
+    const auto component = static_cast<Fmi3Component *>(c);
+    try {
 
-    std::cout << "fmi3EnterEventMode" << std::endl;
+        if (!component->eventModeUsed) {
+            throw std::logic_error("Event mode was not requested when the instance was created.");
+        }
+        const auto from = component->modelExchange ? Fmi3Component::State::ContinuousTimeMode : Fmi3Component::State::StepMode;
+        if (component->state != from) {
+            throw std::logic_error(component->modelExchange ? "Invalid state. Expected ContinuousTimeMode." : "Invalid state. Expected StepMode.");
+        }
 
-    return fmi3Error;
+        component->state = Fmi3Component::State::EventMode;
+        return fmi3OK;
+    } catch (const std::exception &ex) {
+        component->logger->log(fmiError, ex.what());
+        component->state = Fmi3Component::State::Terminated;
+        return fmi3Error;
+    }
 }
 
 fmi3Status fmi3EnterInitializationMode(fmi3Instance c,
@@ -250,8 +397,9 @@ fmi3Status fmi3ExitInitializationMode(fmi3Instance c) {
             throw std::logic_error("Invalid state. Expected InitializationMode.");
         }
 
-        component->slave->exit_initialisation_mode();
-        component->state = Fmi3Component::State::StepMode;
+        component->slave->finish_initialisation();
+        // with event mode, and always in Model Exchange, the events at the start time are handled first
+        component->state = component->eventModeUsed ? Fmi3Component::State::EventMode : Fmi3Component::State::StepMode;
         return fmi3OK;
     } catch (const fmu4cpp::fatal_error &ex) {
         component->logger->log(fmiFatal, ex.what());
@@ -293,15 +441,19 @@ fmi3Status fmi3DoStep(fmi3Instance c,
     const auto component = static_cast<Fmi3Component *>(c);
     try {
 
-        if (component->state != Fmi3Component::State::StepMode) {
+        if (component->modelExchange) {
+            throw std::logic_error("Not available for Model Exchange.");
+        }
+        if (fmu4cpp::checked_access && component->state != Fmi3Component::State::StepMode) {
             throw std::logic_error("Invalid state. Expected StepMode.");
         }
 
         if (component->slave->step(currentCommunicationPoint, communicationStepSize)) {
-            *earlyReturn = false;
+            const auto earlyReturnTime = component->slave->early_return();
+            *earlyReturn = earlyReturnTime.has_value();
             *terminateSimulation = false;
-            *eventHandlingNeeded = false;
-            *lastSuccessfulTime = currentCommunicationPoint + communicationStepSize;
+            *eventHandlingNeeded = component->eventModeUsed && component->slave->event_pending();
+            *lastSuccessfulTime = earlyReturnTime ? *earlyReturnTime : currentCommunicationPoint + communicationStepSize;
             return fmi3OK;
         }
 
@@ -326,7 +478,7 @@ fmi3Status fmi3CancelStep(fmi3Instance) {
 fmi3Status fmi3Reset(fmi3Instance c) {
     const auto component = static_cast<Fmi3Component *>(c);
     try {
-        component->slave->reset();
+        component->slave->reset_instance();
         component->state = Fmi3Component::State::Instantiated;
         return fmi3OK;
     } catch (const fmu4cpp::fatal_error &ex) {
@@ -349,7 +501,7 @@ fmi3Status fmi3GetInt32(
 
     const auto component = static_cast<Fmi3Component *>(c);
     try {
-        component->slave->get_integer(vr, nvr, value);
+        component->slave->get_integer(vr, nvr, value, nValues);
         return fmi3OK;
     } catch (const fmu4cpp::fatal_error &ex) {
         component->logger->log(fmiFatal, ex.what());
@@ -371,7 +523,7 @@ fmi3Status fmi3GetFloat64(
 
     const auto component = static_cast<Fmi3Component *>(c);
     try {
-        component->slave->get_real(vr, nvr, value);
+        component->slave->get_real(vr, nvr, value, nValues);
         return fmi3OK;
     } catch (const fmu4cpp::fatal_error &ex) {
         component->logger->log(fmiFatal, ex.what());
@@ -393,7 +545,7 @@ fmi3Status fmi3GetBoolean(
 
     const auto component = static_cast<Fmi3Component *>(c);
     try {
-        component->slave->get_boolean(vr, nvr, value);
+        component->slave->get_boolean(vr, nvr, value, nValues);
         return fmi3OK;
     } catch (const fmu4cpp::fatal_error &ex) {
         component->logger->log(fmiFatal, ex.what());
@@ -437,7 +589,7 @@ fmi3Status fmi3SetInt32(
 
     const auto component = static_cast<Fmi3Component *>(c);
     try {
-        component->slave->set_integer(vr, nvr, value);
+        component->slave->set_integer(vr, nvr, value, nValues);
         return fmi3OK;
     } catch (const fmu4cpp::fatal_error &ex) {
         component->logger->log(fmiFatal, ex.what());
@@ -459,7 +611,7 @@ fmi3Status fmi3SetFloat64(
 
     const auto component = static_cast<Fmi3Component *>(c);
     try {
-        component->slave->set_real(vr, nvr, value);
+        component->slave->set_real(vr, nvr, value, nValues);
         return fmi3OK;
     } catch (const fmu4cpp::fatal_error &ex) {
         component->logger->log(fmiFatal, ex.what());
@@ -481,7 +633,7 @@ fmi3Status fmi3SetBoolean(
 
     const auto component = static_cast<Fmi3Component *>(c);
     try {
-        component->slave->set_boolean(vr, nvr, value);
+        component->slave->set_boolean(vr, nvr, value, nValues);
         return fmi3OK;
     } catch (const fmu4cpp::fatal_error &ex) {
         component->logger->log(fmiFatal, ex.what());
@@ -561,26 +713,26 @@ fmi3Status fmi3SetBinary(fmi3Instance c,
     }
 }
 
-NOT_IMPLEMENTED_SETTER(UInt8);
-NOT_IMPLEMENTED_SETTER(UInt16);
-NOT_IMPLEMENTED_SETTER(UInt32);
-NOT_IMPLEMENTED_SETTER(UInt64);
+NUMERIC_SETTER(UInt8);
+NUMERIC_SETTER(UInt16);
+NUMERIC_SETTER(UInt32);
+NUMERIC_SETTER(UInt64);
 
-NOT_IMPLEMENTED_GETTER(UInt8);
-NOT_IMPLEMENTED_GETTER(UInt16);
-NOT_IMPLEMENTED_GETTER(UInt32);
-NOT_IMPLEMENTED_GETTER(UInt64);
+NUMERIC_GETTER(UInt8);
+NUMERIC_GETTER(UInt16);
+NUMERIC_GETTER(UInt32);
+NUMERIC_GETTER(UInt64);
 
-NOT_IMPLEMENTED_SETTER(Int8);
-NOT_IMPLEMENTED_SETTER(Int16);
-NOT_IMPLEMENTED_SETTER(Int64);
+NUMERIC_SETTER(Int8);
+NUMERIC_SETTER(Int16);
+NUMERIC_SETTER(Int64);
 
-NOT_IMPLEMENTED_GETTER(Int8);
-NOT_IMPLEMENTED_GETTER(Int16);
-NOT_IMPLEMENTED_GETTER(Int64);
+NUMERIC_GETTER(Int8);
+NUMERIC_GETTER(Int16);
+NUMERIC_GETTER(Int64);
 
-NOT_IMPLEMENTED_SETTER(Float32);
-NOT_IMPLEMENTED_GETTER(Float32);
+NUMERIC_SETTER(Float32);
+NUMERIC_GETTER(Float32);
 
 
 fmi3Status fmi3SetDebugLogging(fmi3Instance c,
@@ -873,80 +1025,151 @@ fmi3Status fmi3EvaluateDiscreteStates(fmi3Instance instance) {
     return fmi3Error;
 }
 
-fmi3Status fmi3UpdateDiscreteStates(fmi3Instance instance,
+fmi3Status fmi3UpdateDiscreteStates(fmi3Instance c,
                                     fmi3Boolean *discreteStatesNeedUpdate,
                                     fmi3Boolean *terminateSimulation,
                                     fmi3Boolean *nominalsOfContinuousStatesChanged,
                                     fmi3Boolean *valuesOfContinuousStatesChanged,
                                     fmi3Boolean *nextEventTimeDefined,
                                     fmi3Float64 *nextEventTime) {
+    const auto component = static_cast<Fmi3Component *>(c);
+    try {
 
-    return fmi3Error;
-}
-
-fmi3Status fmi3EnterContinuousTimeMode(fmi3Instance instance) {
+        if (component->state != Fmi3Component::State::EventMode) {
+            throw std::logic_error("Invalid state. Expected EventMode.");
+        }
 
-    std::cout << "fmi3EnterContinuousTimeMode" << std::endl;
+        const auto update = component->slave->update_discrete_states();
+        *discreteStatesNeedUpdate = update.needsUpdate;
+        *terminateSimulation = false;
+        *nominalsOfContinuousStatesChanged = false;
+        *valuesOfContinuousStatesChanged = false;
+        *nextEventTimeDefined = update.nextEventTime.has_value();
+        *nextEventTime = update.nextEventTime.value_or(0);
+        return fmi3OK;
+    } catch (const fmu4cpp::fatal_error &ex) {
+        component->logger->log(fmiFatal, ex.what());
+        component->state = Fmi3Component::State::Invalid;
+        return fmi3Fatal;
+    } catch (const std::exception &ex) {
+        component->logger->log(fmiError, ex.what());
+        component->state = Fmi3Component::State::Terminated;
+        return fmi3Error;
+    }
+}
 
-    return fmi3Error;
+fmi3Status fmi3EnterContinuousTimeMode(fmi3Instance c) {
+    return invokeModelExchange(c, [c](fmu4cpp::fmu_base &) {
+        const auto component = static_cast<Fmi3Component *>(c);
+        if (component->state != Fmi3Component::State::EventMode) {
+            throw std::logic_error("Invalid state. Expected EventMode.");
+        }
+        component->state = Fmi3Component::State::ContinuousTimeMode;
+    });
 }
 
-fmi3Status fmi3CompletedIntegratorStep(fmi3Instance instance,
-                                       fmi3Boolean noSetFMUStatePriorToCurrentPoint,
+fmi3Status fmi3CompletedIntegratorStep(fmi3Instance c,
+                                       fmi3Boolean /*noSetFMUStatePriorToCurrentPoint*/,
                                        fmi3Boolean *enterEventMode,
                                        fmi3Boolean *terminateSimulation) {
-
-    return fmi3Error;
+    return invokeModelExchange(c, [c, enterEventMode, terminateSimulation](fmu4cpp::fmu_base &slave) {
+        requireState(*static_cast<Fmi3Component *>(c), static_cast<int>(Fmi3Component::State::ContinuousTimeMode),
+                     "ContinuousTimeMode");
+        *enterEventMode = slave.event_pending();
+        *terminateSimulation = false;
+    });
 }
 
-fmi3Status fmi3SetTime(fmi3Instance instance, fmi3Float64 time) {
-    return fmi3Error;
+fmi3Status fmi3SetTime(fmi3Instance c, fmi3Float64 time) {
+    return invokeModelExchange(c, [c, time](fmu4cpp::fmu_base &slave) {
+        requireState(*static_cast<Fmi3Component *>(c),
+                     static_cast<int>(Fmi3Component::State::EventMode) | static_cast<int>(Fmi3Component::State::ContinuousTimeMode),
+                     "EventMode or ContinuousTimeMode");
+        slave.set_time(time);
+    });
 }
 
-fmi3Status fmi3SetContinuousStates(fmi3Instance instance,
+fmi3Status fmi3SetContinuousStates(fmi3Instance c,
                                    const fmi3Float64 continuousStates[],
                                    size_t nContinuousStates) {
-    return fmi3Error;
+    return invokeModelExchange(c, [c, continuousStates, nContinuousStates](fmu4cpp::fmu_base &slave) {
+        requireState(*static_cast<Fmi3Component *>(c), static_cast<int>(Fmi3Component::State::ContinuousTimeMode),
+                     "ContinuousTimeMode");
+        slave.set_continuous_states(continuousStates, nContinuousStates);
+    });
 }
 
-fmi3Status fmi3GetContinuousStateDerivatives(fmi3Instance instance,
+fmi3Status fmi3GetContinuousStateDerivatives(fmi3Instance c,
                                              fmi3Float64 derivatives[],
                                              size_t nContinuousStates) {
-    return fmi3Error;
+    return invokeModelExchange(c, [c, derivatives, nContinuousStates](fmu4cpp::fmu_base &slave) {
+        requireState(*static_cast<Fmi3Component *>(c), STATES_READABLE, STATES_READABLE_NAMES);
+        slave.get_derivatives(derivatives, nContinuousStates);
+    });
 }
 
-fmi3Status fmi3GetEventIndicators(fmi3Instance instance,
-                                  fmi3Float64 eventIndicators[],
+// fmu4cpp models have no event indicators
+fmi3Status fmi3GetEventIndicators(fmi3Instance c,
+                                  fmi3Float64[],
                                   size_t nEventIndicators) {
-    return fmi3Error;
+    return invokeModelExchange(c, [nEventIndicators](fmu4cpp::fmu_base &) {
+        if (nEventIndicators != 0) throw std::invalid_argument("Expected 0 event indicators");
+    });
 }
 
-fmi3Status fmi3GetContinuousStates(fmi3Instance instance,
+fmi3Status fmi3GetContinuousStates(fmi3Instance c,
                                    fmi3Float64 continuousStates[],
                                    size_t nContinuousStates) {
-    return fmi3Error;
+    return invokeModelExchange(c, [c, continuousStates, nContinuousStates](fmu4cpp::fmu_base &slave) {
+        requireState(*static_cast<Fmi3Component *>(c), STATES_READABLE, STATES_READABLE_NAMES);
+        slave.get_continuous_states(continuousStates, nContinuousStates);
+    });
 }
 
-fmi3Status fmi3GetNominalsOfContinuousStates(fmi3Instance instance,
+fmi3Status fmi3GetNominalsOfContinuousStates(fmi3Instance c,
                                              fmi3Float64 nominals[],
                                              size_t nContinuousStates) {
-    return fmi3Error;
+    return invokeModelExchange(c, [c, nominals, nContinuousStates](fmu4cpp::fmu_base &slave) {
+        requireState(*static_cast<Fmi3Component *>(c), STATES_READABLE, STATES_READABLE_NAMES);
+        if (nContinuousStates != slave.number_of_continuous_states()) {
+            throw std::invalid_argument("Wrong number of continuous states");
+        }
+        std::fill(nominals, nominals + nContinuousStates, 1.0);
+    });
 }
-fmi3Status fmi3GetNumberOfEventIndicators(fmi3Instance instance,
+
+fmi3Status fmi3GetNumberOfEventIndicators(fmi3Instance c,
                                           size_t *nEventIndicators) {
-    return fmi3Error;
+    return invokeModelExchange(c, [nEventIndicators](fmu4cpp::fmu_base &) {
+        *nEventIndicators = 0;
+    });
 }
 
-fmi3Status fmi3GetNumberOfContinuousStates(fmi3Instance instance,
+fmi3Status fmi3GetNumberOfContinuousStates(fmi3Instance c,
                                            size_t *nContinuousStates) {
-    return fmi3Error;
+    return invokeModelExchange(c, [nContinuousStates](fmu4cpp::fmu_base &slave) {
+        *nContinuousStates = slave.number_of_continuous_states();
+    });
 }
 
-fmi3Status fmi3EnterStepMode(fmi3Instance instance) {
+fmi3Status fmi3EnterStepMode(fmi3Instance c) {
+    const auto component = static_cast<Fmi3Component *>(c);
+    try {
 
-    std::cout << "fmi3EnterStepMode" << std::endl;
+        if (component->modelExchange) {
+            throw std::logic_error("Not available for Model Exchange.");
+        }
+        if (component->state != Fmi3Component::State::EventMode) {
+            throw std::logic_error("Invalid state. Expected EventMode.");
+        }
 
-    return fmi3Error;
+        component->state = Fmi3Component::State::StepMode;
+        return fmi3OK;
+    } catch (const std::exception &ex) {
+        component->logger->log(fmiError, ex.what());
+        component->state = Fmi3Component::State::Terminated;
+        return fmi3Error;
+    }
 }
 
 fmi3Status fmi3ActivateModelPartition(fmi3Instance instance,
@@ -964,4 +1187,200 @@ void fmi3FreeInstance(fmi3Instance c) {
         c = nullptr;
     }
 }
+
+fmu4cppAccessPlan fmu4cppPrepareAccess(void *instance, const unsigned int vr[], size_t nvr) {
+    const auto component = static_cast<Fmi3Component *>(instance);
+    try {
+        auto plan = std::make_unique<Fmi3AccessPlan>();
+        plan->component = component;
+        plan->plan = component->slave->prepare_access(vr, nvr);
+        return component->accessPlans.emplace_back(std::move(plan)).get();
+    } catch (const std::exception &ex) {
+        component->logger->log(fmiError, ex.what());
+        return nullptr;
+    }
+}
+
+void fmu4cppFreeAccess(fmu4cppAccessPlan p) {
+    if (p) {
+        const auto plan = static_cast<Fmi3AccessPlan *>(p);
+        auto &plans = plan->component->accessPlans;
+        plans.erase(std::remove_if(plans.begin(), plans.end(), [plan](const auto &it) {
+                        return it.get() == plan;
+                    }),
+                    plans.end());
+    }
+}
+
+fmiStatus fmu4cppGetIntegerPrepared(fmu4cppAccessPlan plan, int values[]) {
+    return invokePrepared(plan, [values](auto &slave, const auto &p) { slave.get_integer(p, values); });
+}
+
+fmiStatus fmu4cppGetRealPrepared(fmu4cppAccessPlan plan, double values[]) {
+    return invokePrepared(plan, [values](auto &slave, const auto &p) { slave.get_real(p, values); });
+}
+
+fmiStatus fmu4cppGetBooleanPrepared(fmu4cppAccessPlan plan, bool values[]) {
+    return invokePrepared(plan, [values](auto &slave, const auto &p) { slave.get_boolean(p, values); });
+}
+
+fmiStatus fmu4cppSetIntegerPrepared(fmu4cppAccessPlan plan, const int values[]) {
+    return invokePrepared(plan, [values](auto &slave, const auto &p) { slave.set_integer(p, values); });
+}
+
+fmiStatus fmu4cppSetRealPrepared(fmu4cppAccessPlan plan, const double values[]) {
+    return invokePrepared(plan, [values](auto &slave, const auto &p) { slave.set_real(p, values); });
+}
+
+fmiStatus fmu4cppSetBooleanPrepared(fmu4cppAccessPlan plan, const bool values[]) {
+    return invokePrepared(plan, [values](auto &slave, const auto &p) { slave.set_boolean(p, values); });
+}
+
+fmiStatus fmu4cppGetChangedOutputs(void *instance, uint64_t *token, unsigned int vr[], size_t capacity, size_t *nvr) {
+    const auto component = static_cast<Fmi3Component *>(instance);
+    try {
+        auto &changed = component->changedOutputs;
+        changed.clear();
+        const auto next = component->slave->changed_outputs(*token, changed);
+        *nvr = changed.size();
+        if (changed.size() > capacity) {
+            return fmiDiscard;
+        }
+        std::copy(changed.begin(), changed.end(), vr);
+        *token = next;
+        return fmiOK;
+    } catch (const fmu4cpp::fatal_error &ex) {
+        component->logger->log(fmiFatal, ex.what());
+        component->state = Fmi3Component::State::Invalid;
+        return fmiFatal;
+    } catch (const std::exception &ex) {
+        component->logger->log(fmiError, ex.what());
+        component->state = Fmi3Component::State::Terminated;
+        return fmiError;
+    }
+}
+
+fmiStatus fmu4cppSetOutputsChangedCallback(void *instance, fmu4cppOutputsChangedCallback callback, void *environment) {
+    const auto component = static_cast<Fmi3Component *>(instance);
+    if (callback) {
+        component->slave->set_outputs_changed_callback([callback, environment](const unsigned int vr[], size_t nvr) {
+            callback(environment, vr, nvr);
+        });
+    } else {
+        component->slave->set_outputs_changed_callback(nullptr);
+    }
+    return fmiOK;
+}
+
+fmiStatus fmu4cppEnableOutputSnapshot(void *instance) {
+    const auto component = static_cast<Fmi3Component *>(instance);
+    try {
+        component->slave->enable_output_snapshot();
+        return fmiOK;
+    } catch (const fmu4cpp::fatal_error &ex) {
+        component->logger->log(fmiFatal, ex.what());
+        component->state = Fmi3Component::State::Invalid;
+        return fmiFatal;
+    } catch (const std::exception &ex) {
+        component->logger->log(fmiError, ex.what());
+        component->state = Fmi3Component::State::Terminated;
+        return fmiError;
+    }
+}
+
+fmiStatus fmu4cppReadOutputSnapshot(void *instance, const unsigned int vr[], size_t nvr, double values[], double *time) {
+    // called from other threads, so neither logging nor touching the component state
+    const auto component = static_cast<const Fmi3Component *>(instance);
+    return component->slave->read_output_snapshot(vr, nvr, values, time) ? fmiOK : fmiError;
+}
+
+fmiStatus fmu4cppExchangeStep(void *instance, const fmu4cppStepValues *inputs,
+                              double currentTime, double stepSize, fmu4cppStepValues *outputs,
+                              double *lastSuccessfulTime, bool *earlyReturn, bool *eventHandlingNeeded) {
+    const auto component = static_cast<Fmi3Component *>(instance);
+    try {
+        if (component->modelExchange) {
+            throw std::logic_error("Not available for Model Exchange.");
+        }
+        if (fmu4cpp::checked_access && component->state != Fmi3Component::State::StepMode) {
+            throw std::logic_error("Invalid state. Expected StepMode.");
+        }
+
+        auto &slave = *component->slave;
+        if (inputs) fmu4cpp::set_step_inputs(slave, *inputs);
+
+        auto status = fmiOK;
+        double reached = currentTime;
+        bool returnedEarly = false;
+        bool eventPending = false;
+        if (slave.step(currentTime, stepSize)) {
+            // as in fmi3DoStep
+            const auto earlyReturnTime = slave.early_return();
+            returnedEarly = earlyReturnTime.has_value();
+            eventPending = component->eventModeUsed && slave.event_pending();
+            reached = earlyReturnTime ? *earlyReturnTime : currentTime + stepSize;
+        } else {
+            component->logger->log(fmiWarning, "Step returned false!");
+            status = fmiDiscard;
+        }
+        if (lastSuccessfulTime) *lastSuccessfulTime = reached;
+        if (earlyReturn) *earlyReturn = returnedEarly;
+        if (eventHandlingNeeded) *eventHandlingNeeded = eventPending;
+
+        if (outputs) fmu4cpp::get_step_outputs(slave, *outputs);
+        return status;
+    } catch (const fmu4cpp::fatal_error &ex) {
+        component->logger->log(fmiFatal, ex.what());
+        component->state = Fmi3Component::State::Invalid;
+        return fmiFatal;
+    } catch (const std::exception &ex) {
+        component->logger->log(fmiError, ex.what());
+        component->state = Fmi3Component::State::Terminated;
+        return fmiError;
+    }
+}
+
+fmiStatus fmu4cppDoSteps(void *instance, double currentTime, double stepSize, size_t nSteps,
+                         const fmu4cppStepSeries *series, size_t *nCompleted, double *lastSuccessfulTime) {
+    const auto component = static_cast<Fmi3Component *>(instance);
+    *nCompleted = 0;
+    double time = currentTime;
+    auto status = fmiOK;
+    try {
+        if (component->modelExchange) {
+            throw std::logic_error("Not available for Model Exchange.");
+        }
+        if (fmu4cpp::checked_access && component->state != Fmi3Component::State::StepMode) {
+            throw std::logic_error("Invalid state. Expected StepMode.");
+        }
+
+        auto &slave = *component->slave;
+        const fmu4cpp::step_series steps(slave, series, nSteps);
+
+        for (size_t k = 0; k < nSteps; k++) {
+            steps.set_inputs(slave, k);
+            if (!slave.step(time, stepSize)) {
+                component->logger->log(fmiWarning, "Step returned false!");
+                status = fmiDiscard;
+                break;
+            }
+            const auto earlyReturnTime = slave.early_return();
+            time = earlyReturnTime ? *earlyReturnTime : time + stepSize;// as fmu_base advances its own time
+            steps.get_outputs(slave, k);
+            ++*nCompleted;
+            // the importer has to take over
+            if (earlyReturnTime || (component->eventModeUsed && slave.event_pending())) break;
+        }
+    } catch (const fmu4cpp::fatal_error &ex) {
+        component->logger->log(fmiFatal, ex.what());
+        component->state = Fmi3Component::State::Invalid;
+        status = fmiFatal;
+    } catch (const std::exception &ex) {
+        component->logger->log(fmiError, ex.what());
+        component->state = Fmi3Component::State::Terminated;
+        status = fmiError;
+    }
+    if (lastSuccessfulTime) *lastSuccessfulTime = time;
+    return status;
+}
 }
@@ -23,6 +23,22 @@ namespace {
             return "Boolean";
         } else if (dynamic_cast<const BinaryVariable *>(v)) {
             return "Binary";
+        } else if (dynamic_cast<const Float32Variable *>(v)) {
+            return "Float32";
+        } else if (dynamic_cast<const Int8Variable *>(v)) {
+            return "Int8";
+        } else if (dynamic_cast<const UInt8Variable *>(v)) {
+            return "UInt8";
+        } else if (dynamic_cast<const Int16Variable *>(v)) {
+            return "Int16";
+        } else if (dynamic_cast<const UInt16Variable *>(v)) {
+            return "UInt16";
+        } else if (dynamic_cast<const UInt32Variable *>(v)) {
+            return "UInt32";
+        } else if (dynamic_cast<const Int64Variable *>(v)) {
+            return "Int64";
+        } else if (dynamic_cast<const UInt64Variable *>(v)) {
+            return "UInt64";
         }
         throw std::runtime_error("Unknown variable type");
     }
@@ -38,6 +54,38 @@ namespace {
         return out;
     }
 
+    // Elements after the first are folded into the array variable, which takes the first element's value reference
+    bool folded_into_array(const VariableBase &v) {
+        return v.array_offset() > 0;
+    }
+
+    // Space separated start values of all elements of the array starting at first
+    template<typename V>
+    void write_array_start(std::ostream &ss, const V *first) {
+        const auto size = first->array()->size;
+        for (size_t i = 0; i < size; i++) {
+            if (i > 0) ss << " ";
+            ss << first[i].get();// the elements are registered one after another
+        }
+    }
+
+    // start, min and max of a NumericVariable<T>. Returns false if v is of another type.
+    template<typename T>
+    bool write_numeric(std::ostream &ss, const VariableBase *v, bool with_start) {
+        const auto n = dynamic_cast<const NumericVariable<T> *>(v);
+        if (!n) return false;
+
+        // unary + so that 8 bit integers are not written as characters
+        if (with_start) {
+            ss << " start=\"" << +n->get() << "\"";
+        }
+        const auto min = n->getMin();
+        const auto max = n->getMax();
+        if (min) ss << " min=\"" << +*min << "\"";
+        if (max) ss << " max=\"" << +*max << "\"";
+        return true;
+    }
+
 }// namespace
 
 
@@ -56,14 +104,30 @@ std::string fmu_base::make_description() const {
        << "\tvariableNamingConvention=\"" << m.variableNamingConvention << "\""
        << ">\n\n";
 
-    ss << std::boolalpha
-       << "\t<CoSimulation\n"
+    ss << std::boolalpha;
+    if (provides_model_exchange()) {
+        ss << "\t<ModelExchange\n"
+           << "\t\tneedsExecutionTool=\"" << m.needsExecutionTool << "\"\n"
+           << "\t\tmodelIdentifier=\"" << model_identifier() << "\"\n"
+           << "\t\tcanBeInstantiatedOnlyOncePerProcess=\"" << m.canBeInstantiatedOnlyOncePerProcess << "\"\n"
+           << "\t\tcanGetAndSetFMUstate=\"" << m.canGetAndSetFMUstate << "\"\n"
+           << "\t\tcanSerializeFMUstate=\"" << m.canSerializeFMUstate << "\"\n"
+           << "\t\tprovidesDirectionalDerivatives=\"false\"" << "\n"
+           << "\t\tprovidesAdjointDerivatives=\"false\"" << "\n"
+           << "\t\tprovidesPerElementDependencies=\"false\"" << "\n"
+           << "\t\tprovidesEvaluateDiscreteStates=\"false\""
+           << "/>\n\n";
+    }
+    ss << "\t<CoSimulation\n"
        << "\t\tneedsExecutionTool=\"" << m.needsExecutionTool << "\"\n"
        << "\t\tmodelIdentifier=\"" << model_identifier() << "\"\n"
        << "\t\tcanHandleVariableCommunicationStepSize=\"" << m.canHandleVariableCommunicationStepSize << "\"\n"
        << "\t\tcanBeInstantiatedOnlyOncePerProcess=\"" << m.canBeInstantiatedOnlyOncePerProcess << "\"\n"
        << "\t\tcanGetAndSetFMUstate=\"" << m.canGetAndSetFMUstate << "\"\n"
        << "\t\tcanSerializeFMUstate=\"" << m.canSerializeFMUstate << "\"\n"
+       << "\t\thasEventMode=\"" << m.hasEventMode << "\"\n"
+       << "\t\tprovidesIntermediateUpdate=\"" << m.providesIntermediateUpdate << "\"\n"
+       << "\t\tcanReturnEarlyAfterIntermediateUpdate=\"" << m.canReturnEarlyAfterIntermediateUpdate << "\"\n"
        << "\t\tprovidesDirectionalDerivatives=\"false\"" << "\n"
        << "\t\tprovidesAdjointDerivatives=\"false\"" << "\n"
        << "\t\tprovidesPerElementDependencies=\"false\"" << "\n"
@@ -84,8 +148,11 @@ std::string fmu_base::make_description() const {
 
     ss << "\t<ModelVariables>\n";
 
+    const auto rangeElements = range_elements();
     const auto allVars = [&] {
         auto allVars = collect(integers_, reals_, booleans_, strings_, binary_);
+        collect_numerics(allVars);
+        collect_ranges(allVars, rangeElements);
         std::sort(allVars.begin(), allVars.end(), [](const VariableBase *v1, const VariableBase *v2) {
             return v1->index() < v2->index();
         });
@@ -93,13 +160,16 @@ std::string fmu_base::make_description() const {
     }();
 
     for (const auto &v: allVars) {
+        if (folded_into_array(*v)) continue;
+
+        const auto array = v->array();
         const auto variability = v->variability();
         const auto initial = v->initial();
         const auto annotations = v->getAnnotations();
         ss << "\t\t<!--"
            << "index=" << v->index() << "-->\n"
            << "\t\t<" << type(v) << " name=\""
-           << v->name() << "\" valueReference=\"" << v->value_reference() << "\""
+           << (array ? array->name : v->name()) << "\" valueReference=\"" << v->value_reference() << "\""
            << " causality=\"" << to_string(v->causality()) << "\"";
 
         if (variability) {
@@ -117,24 +187,45 @@ std::string fmu_base::make_description() const {
         if (auto i = dynamic_cast<const IntVariable *>(v)) {
 
             if (with_start) {
-                ss << " start=\"" << i->get() << "\"";
+                ss << " start=\"";
+                if (array) {
+                    write_array_start(ss, i);
+                } else {
+                    ss << i->get();
+                }
+                ss << "\"";
             }
 
         } else if (auto r = dynamic_cast<const RealVariable *>(v)) {
 
             if (with_start) {
-                ss << " start=\"" << r->get() << "\"";
+                ss << " start=\"";
+                if (array) {
+                    write_array_start(ss, r);
+                } else {
+                    ss << r->get();
+                }
+                ss << "\"";
             }
             const auto min = r->getMin();
             const auto max = r->getMax();
             if (min && max) {
                 ss << " min=\"" << *min << "\" max=\"" << *max << "\"";
             }
+            if (const auto state = r->getDerivative()) {
+                ss << " derivative=\"" << *state << "\"";
+            }
 
         } else if (auto b = dynamic_cast<const BoolVariable *>(v)) {
 
             if (with_start) {
-                ss << " start=\"" << b->get() << "\"";
+                ss << " start=\"";
+                if (array) {
+                    write_array_start(ss, b);
+                } else {
+                    ss << b->get();
+                }
+                ss << "\"";
             }
 
         } else if (auto s = dynamic_cast<const StringVariable *>(v)) {
@@ -150,9 +241,21 @@ std::string fmu_base::make_description() const {
                 ss << "\t\t\t<Dimension start=\"1\"/>\n";
                 ss << "\t\t\t<Start value=\"" << hex_encode(bin->get()) << "\"/>\n";
             }
+        } else {
+            write_numeric<float>(ss, v, with_start) ||
+                    write_numeric<int8_t>(ss, v, with_start) || write_numeric<uint8_t>(ss, v, with_start) ||
+                    write_numeric<int16_t>(ss, v, with_start) || write_numeric<uint16_t>(ss, v, with_start) ||
+                    write_numeric<uint32_t>(ss, v, with_start) ||
+                    write_numeric<int64_t>(ss, v, with_start) || write_numeric<uint64_t>(ss, v, with_start);
         }
 
-        if (with_start) {
+        if (array) {
+            ss << ">\n";
+            for (const auto d: array->dimensions) {
+                ss << "\t\t\t<Dimension start=\"" << d << "\"/>\n";
+            }
+            ss << "\t\t</" << type(v) << ">\n";
+        } else if (with_start) {
             if (dynamic_cast<const StringVariable *>(v)) {
                 ss << "\t\t</String>\n";
             } else if (dynamic_cast<const BinaryVariable *>(v)) {
@@ -178,9 +281,12 @@ std::string fmu_base::make_description() const {
 
     ss << "\t<ModelStructure>\n";
 
-    const auto unknowns = collect(integers_, reals_, booleans_, strings_, [](auto &v) {
-        return v.causality() == causality_t::OUTPUT;
-    });
+    const auto isOutput = [](const VariableBase &v) {
+        return v.causality() == causality_t::OUTPUT && !folded_into_array(v);
+    };
+    auto unknowns = collect(integers_, reals_, booleans_, strings_, isOutput);
+    collect_numerics(unknowns, isOutput);
+    collect_ranges(unknowns, rangeElements, isOutput);
 
     if (!unknowns.empty()) {
         for (const auto &v: unknowns) {
@@ -195,7 +301,7 @@ std::string fmu_base::make_description() const {
                     if (dep == allVars.end()) {
                         throw std::runtime_error("Unknown dependency: " + depName);
                     }
-                    ss << (*dep)->value_reference();
+                    ss << (*dep)->value_reference() - (*dep)->array_offset();
                     if (i != deps.size() - 1) {
                         ss << " ";
                     }
@@ -206,9 +312,19 @@ std::string fmu_base::make_description() const {
         }
     }
 
-    const auto initialUnknowns = collect(integers_, reals_, booleans_, strings_, [](auto &v) {
+    for (const auto &v: rangeElements) {
+        if (v.getDerivative()) {
+            ss << "\t\t<ContinuousStateDerivative valueReference=\"" << v.value_reference() << "\"/>\n";
+        }
+    }
+
+    const auto isInitialUnknown = [](const VariableBase &v) {
+        if (folded_into_array(v)) return false;
         return (v.causality() == causality_t::OUTPUT && v.initial() == initial_t::APPROX || v.initial() == initial_t::CALCULATED) || v.causality() == causality_t::CALCULATED_PARAMETER;
-    });
+    };
+    auto initialUnknowns = collect(integers_, reals_, booleans_, strings_, isInitialUnknown);
+    collect_numerics(initialUnknowns, isInitialUnknown);
+    collect_ranges(initialUnknowns, rangeElements, isInitialUnknown);
     if (!initialUnknowns.empty()) {
         for (const auto &v: initialUnknowns) {
             ss << "\t\t<InitialUnknown valueReference=\"" << v->index() - 1 << "\"";
@@ -218,6 +334,12 @@ std::string fmu_base::make_description() const {
 
     ss << "\t</ModelStructure>\n\n";
 
+    ss << "\t<Annotations>\n";
+    ss << "\t\t<Annotation type=\"fmu4cpp\">\n";
+    ss << indent_multiline_string(vendor_tool_annotation(), 3) << "\n";
+    ss << "\t\t</Annotation>\n";
+    ss << "\t</Annotations>\n\n";
+
     // if (!m.vendorAnnotations.empty()) {
     //     ss << "\t<Annotations>\n";
     //     for (const auto &annotation: m.vendorAnnotations) {
@@ -7,13 +7,55 @@
 #include "hash.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstring>
 #include <functional>
 #include <sstream>
+#include <stdexcept>
+#include <thread>
 #include <utility>
 
 
 using namespace fmu4cpp;
 
+namespace {
+
+    // kept out of line so that the lookup in the get/set loops stays small
+    [[noreturn]] void invalid_value_reference(unsigned int vr) {
+        throw std::out_of_range("Invalid value reference: " + std::to_string(vr));
+    }
+
+}// namespace
+
+// A seqlock protected copy of the outputs. Only the stepping thread writes, so writers never wait.
+// Readers retry if a step was published while they were copying.
+struct fmu_base::output_snapshot {
+    template<typename T>
+    struct direct_source {
+        const T *ptr;
+        size_t slot;
+    };
+
+    std::atomic<uint64_t> sequence{0};
+    std::vector<int32_t> slotOf;// per value reference, index into values or -1
+    size_t size{0};
+    // pointer-backed outputs are read directly, only getter-backed ones go through a callable
+    std::vector<direct_source<int>> integers;
+    std::vector<direct_source<double>> reals;
+    std::vector<direct_source<bool>> booleans;
+    std::vector<std::pair<std::function<double()>, size_t>> computed;
+    std::unique_ptr<std::atomic<double>[]> values;
+
+    template<typename T>
+    void store(const std::vector<direct_source<T>> &sources) {
+        for (const auto &source: sources) {
+            values[source.slot].store(static_cast<double>(*source.ptr), std::memory_order_relaxed);
+        }
+    }
+};
+
 fmu_base::fmu_base(fmu_data data) : data_(std::move(data)) {
 
     register_real("time", &time_)
@@ -23,45 +65,174 @@ fmu_base::fmu_base(fmu_data data) : data_(std::move(data)) {
 }
 
 
-std::optional<IntVariable> fmu_base::get_int_variable(const std::string &name) const {
-    for (const auto &v: integers_) {
-        if (v.name() == name) return v;
+template<typename V>
+const V *fmu_base::find_variable(std::string_view name, value_type type, const std::vector<V> &vars) const {
+    const auto [first, last] = nameIndex_.equal_range(fnv1a(name));
+    for (auto it = first; it != last; ++it) {
+        const vr_entry entry = vrTable_[it->second];
+        if (entry.type == type && vars[entry.index].name() == name) {
+            return &vars[entry.index];
+        }
+    }
+    return nullptr;
+}
+
+template<typename T>
+VarHandle<T> fmu_base::handle(std::string_view name) {
+    auto &vars = variables_of<T>();
+    const auto v = find_variable(name, type_of<T>(), vars);
+    if (!v) {
+        throw std::invalid_argument("No variable named " + std::string(name) + " of the requested type");
+    }
+    return {*this, vars, static_cast<size_t>(v - vars.data())};
+}
+
+const IntVariable *fmu_base::find_int_variable(std::string_view name) const {
+    return find_variable(name, value_type::INTEGER, integers_);
+}
+
+const RealVariable *fmu_base::find_real_variable(std::string_view name) const {
+    return find_variable(name, value_type::REAL, reals_);
+}
+
+const BoolVariable *fmu_base::find_bool_variable(std::string_view name) const {
+    return find_variable(name, value_type::BOOLEAN, booleans_);
+}
+
+const StringVariable *fmu_base::find_string_variable(std::string_view name) const {
+    return find_variable(name, value_type::STRING, strings_);
+}
+
+const BinaryVariable *fmu_base::find_binary_variable(std::string_view name) const {
+    return find_variable(name, value_type::BINARY, binary_);
+}
+
+const std::vector<fmu_base::name_entry> &fmu_base::sorted_names() const {
+    if (sortedNamesFor_ == numVariables_) return sortedNames_;
+
+    auto vars = collect(integers_, reals_, booleans_, strings_, binary_);
+    collect_numerics(vars);
+    sortedNames_.clear();
+    sortedNames_.reserve(vars.size() + realRanges_.size());
+    for (const auto v: vars) {
+        sortedNames_.push_back({v->name(), v->value_reference(), 1});
+    }
+    for (const auto &range: realRanges_) {
+        sortedNames_.push_back({range.name(), range.value_reference(), range.size()});
     }
+    std::sort(sortedNames_.begin(), sortedNames_.end(), [](const name_entry &a, const name_entry &b) {
+        return a.name < b.name;
+    });
+    sortedNamesFor_ = numVariables_;
+    return sortedNames_;
+}
+
+namespace {
+
+    // Whether a name starting with prefix is the prefix itself, or a member or element of it
+    bool continues_structured_name(std::string_view name, std::string_view prefix) {
+        if (name.size() == prefix.size()) return true;
+        const char next = name[prefix.size()];
+        return next == '.' || next == '[';
+    }
+
+    // The offset of an element name like sig[3] within the range named sig, if it is one
+    std::optional<size_t> range_element_offset(std::string_view element, const RealRange &range) {
+        const std::string_view name = range.name();
+        if (element.size() < name.size() + 3 || element.substr(0, name.size()) != name ||
+            element[name.size()] != '[' || element.back() != ']') {
+            return std::nullopt;
+        }
+        const auto first = element.data() + name.size() + 1;
+        const auto last = element.data() + element.size() - 1;
+        size_t offset;
+        const auto [end, ec] = std::from_chars(first, last, offset);
+        if (ec != std::errc() || end != last || offset >= range.size()) return std::nullopt;
+        return offset;
+    }
+
+}// namespace
+
+std::vector<fmu_base::vr_range> fmu_base::find_subtree(std::string_view prefix) const {
+    const auto &names = sorted_names();
+
+    std::vector<std::pair<unsigned int, size_t>> matches;// first value reference and count
+    auto it = std::lower_bound(names.begin(), names.end(), prefix, [](const name_entry &e, std::string_view p) {
+        return e.name < p;
+    });
+    for (; it != names.end() && it->name.substr(0, prefix.size()) == prefix; ++it) {
+        if (continues_structured_name(it->name, prefix)) matches.emplace_back(it->vr, it->size);
+    }
+    // range elements are not in the index by their own name
+    for (const auto &range: realRanges_) {
+        if (const auto offset = range_element_offset(prefix, range)) {
+            matches.emplace_back(range.value_reference() + static_cast<unsigned int>(*offset), 1);
+        }
+    }
+    std::sort(matches.begin(), matches.end());
+
+    std::vector<vr_range> result;
+    for (const auto &[first, size]: matches) {
+        const auto type = vrTable_[first].type;
+        if (!result.empty() && result.back().type == type && result.back().first + result.back().size == first) {
+            result.back().size += size;
+        } else {
+            result.push_back({type, first, size});
+        }
+    }
+    return result;
+}
+
+IntVariable &fmu_base::int_variable(std::string_view name) {
+    if (const auto v = find_int_variable(name)) return const_cast<IntVariable &>(*v);
+    throw std::invalid_argument("No Integer variable named " + std::string(name));
+}
+
+RealVariable &fmu_base::real_variable(std::string_view name) {
+    if (const auto v = find_real_variable(name)) return const_cast<RealVariable &>(*v);
+    throw std::invalid_argument("No Real variable named " + std::string(name));
+}
+
+BoolVariable &fmu_base::bool_variable(std::string_view name) {
+    if (const auto v = find_bool_variable(name)) return const_cast<BoolVariable &>(*v);
+    throw std::invalid_argument("No Boolean variable named " + std::string(name));
+}
+
+std::optional<IntVariable> fmu_base::get_int_variable(const std::string &name) const {
+    if (const auto v = find_int_variable(name)) return *v;
     return std::nullopt;
 }
 
 std::optional<RealVariable> fmu_base::get_real_variable(const std::string &name) const {
-    for (const auto &v: reals_) {
-        if (v.name() == name) return v;
-    }
+    if (const auto v = find_real_variable(name)) return *v;
     return std::nullopt;
 }
 
 std::optional<BoolVariable> fmu_base::get_bool_variable(const std::string &name) const {
-    for (const auto &v: booleans_) {
-        if (v.name() == name) return v;
-    }
+    if (const auto v = find_bool_variable(name)) return *v;
     return std::nullopt;
 }
 
 std::optional<StringVariable> fmu_base::get_string_variable(const std::string &name) const {
-    for (const auto &v: strings_) {
-        if (v.name() == name) return v;
-    }
+    if (const auto v = find_string_variable(name)) return *v;
     return std::nullopt;
 }
 
 std::optional<BinaryVariable> fmu_base::get_binary_variable(const std::string &name) const {
-    for (const auto &v: binary_) {
-        if (v.name() == name) return v;
-    }
+    if (const auto v = find_binary_variable(name)) return *v;
     return std::nullopt;
 }
 
 void fmu_base::enter_initialisation_mode(double start, std::optional<double> stop, std::optional<double> tolerance) {
+    mode_ = fmu_mode::INITIALISATION;
+    settable_.clear();// attributes are final by now, rebuilt on the next set
     time_ = start;
+    tickOrigin_ = start;
+    ticks_ = 0;
     stop_ = stop;
     tolerance_ = tolerance;
+    timeEvents_ = {};
+    invalidate();
     enter_initialisation_mode();
 }
 
@@ -76,21 +247,344 @@ bool fmu_base::step(double currentTime, double dt) {
     }
 
     constexpr double TIME_TOLERANCE = 1e-9;
-    if (std::abs(currentTime - time_) > TIME_TOLERANCE) {
+    if (checked_access && std::abs(currentTime - time_) > TIME_TOLERANCE) {
         throw std::runtime_error("Current time does not match the internal time (within tolerance)");
     }
 
-    if (do_step(dt)) {
-        time_ += dt;
+    stepEnd_ = time_ + dt;
+    pendingReturn_.reset();
+    earlyReturn_.reset();
 
+    if (internalStep_ ? sub_cycle(dt) : step_to_events()) {
+        if (!internalStep_) time_ = earlyReturn_ ? *earlyReturn_ : stepEnd_;
+        if (!eventModeUsed_ && event_pending()) handle_events();
+
+        if (snapshot_) publish_output_snapshot();
+
+        if (changeTracking_) {
+            update_change_tracking();
+            if (outputsChanged_ && !changedBuffer_.empty()) {
+                outputsChanged_(changedBuffer_.data(), changedBuffer_.size());
+            }
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+// Without an internal step, do_step is run up to each time event within the step.
+bool fmu_base::step_to_events() {
+    constexpr double TIME_TOLERANCE = 1e-9;
+    while (!timeEvents_.empty() && timeEvents_.top() < stepEnd_ - TIME_TOLERANCE) {
+        const double event = timeEvents_.top();
+        if (event > time_ + TIME_TOLERANCE) {
+            if (eventModeUsed_ && !earlyReturnAllowed_) break;// reported once the step is done
+            if (!do_step(event - time_)) return false;
+            if (earlyReturn_) return true;
+            time_ = event;
+            if (eventModeUsed_) {
+                earlyReturn_ = event;
+                return true;
+            }
+        } else if (eventModeUsed_) {
+            break;// due at the start of the step, but left unhandled by the importer
+        }
+        handle_events();
+    }
+    return do_step(stepEnd_ - time_);
+}
+
+bool fmu_base::do_substep(double) {
+    throw fatal_error("do_substep not implemented by FMU");
+}
+
+void fmu_base::set_internal_step(double stepSize, internal_step kind) {
+    if (!(stepSize > 0)) {
+        throw std::invalid_argument("The internal step size must be positive");
+    }
+    internalStep_ = stepSize;
+    internalStepKind_ = kind;
+}
+
+// On failure, the time is left at the end of the last successful sub-step.
+bool fmu_base::sub_cycle(double dt) {
+    const double h = *internalStep_;
+
+    if (internalStepKind_ == internal_step::FIXED) {
+        const auto n = std::llround(dt / h);
+        if (n < 1 || std::abs(static_cast<double>(n) * h - dt) > 1e-9 * std::max(1.0, dt)) {
+            throw std::invalid_argument("The communication step size " + std::to_string(dt) +
+                                        " is not a multiple of the internal step size " + std::to_string(h));
+        }
+        for (long long i = 1; i <= n; i++) {
+            if (!do_substep(h)) return false;
+            time_ = tickOrigin_ + static_cast<double>(++ticks_) * h;
+            if (i < n && substep_ends_step()) return true;
+        }
+        earlyReturn_.reset();// requested during the last sub-step
+        return true;
+    }
+
+    const auto n = std::max(1LL, static_cast<long long>(std::ceil(dt / h - 1e-9)));
+    const double subStep = dt / static_cast<double>(n);
+    const double start = time_;
+    for (long long i = 1; i < n; i++) {
+        if (!do_substep(subStep)) return false;
+        time_ = start + static_cast<double>(i) * subStep;
+        if (substep_ends_step()) return true;
+    }
+    if (!do_substep(subStep)) return false;
+    time_ = start + dt;
+    earlyReturn_.reset();
+    return true;
+}
+
+// Called after every sub-step but the last, which ends the step anyway.
+bool fmu_base::substep_ends_step() {
+    if (event_pending()) {
+        if (!eventModeUsed_) {
+            handle_events();
+        } else if (earlyReturnAllowed_) {
+            earlyReturn_ = time_;
+        }
+    }
+    if (earlyReturn_ || publish_intermediate(time_)) {
+        earlyReturn_ = time_;
         return true;
     }
+    return false;
+}
+
+void fmu_base::set_intermediate_update(intermediate_update_callback callback, bool earlyReturnAllowed,
+                                       std::vector<unsigned int> requiredVariables) {
+    for (const auto vr : requiredVariables) {
+        if (vr >= numVariables_) {
+            throw std::invalid_argument("Invalid intermediate variable value reference: " + std::to_string(vr));
+        }
+    }
+    intermediateUpdate_ = std::move(callback);
+    earlyReturnAllowed_ = earlyReturnAllowed;
+    intermediateVariables_ = std::move(requiredVariables);
+}
+
+bool fmu_base::publish_intermediate(double time) {
+    if (intermediateUpdate_) {
+        const auto requested = intermediateUpdate_(time, earlyReturnAllowed_);
+        if (requested && earlyReturnAllowed_) pendingReturn_ = requested;
+    }
+    if (pendingReturn_ && time >= *pendingReturn_ - 1e-9 && time < stepEnd_) {
+        earlyReturn_ = time;
+        return true;
+    }
+    return false;
+}
+
+bool fmu_base::request_early_return(double time) {
+    if (!earlyReturnAllowed_) return false;
+    if ((time < time_ - 1e-9 || time > stepEnd_ + 1e-9)) {
+        throw std::invalid_argument("The early return time " + std::to_string(time) + " is outside of the current step");
+    }
+    if (time < stepEnd_) earlyReturn_ = time;
+    return true;
+}
+
+bool fmu_base::event_pending() const {
+    return !timeEvents_.empty() && timeEvents_.top() <= time_ + 1e-9;
+}
+
+fmu_base::discrete_update fmu_base::update_discrete_states() {
+    bool timeEvent = false;
+    while (event_pending()) {
+        timeEvents_.pop();
+        timeEvent = true;
+    }
+    discrete_update update;
+    update.needsUpdate = do_discrete_update(timeEvent);
+    invalidate();
+    if (!timeEvents_.empty()) update.nextEventTime = timeEvents_.top();
+    return update;
+}
+
+// Event iteration within step(), for importers that do not use event mode.
+void fmu_base::handle_events() {
+    constexpr int MAX_ITERATIONS = 100;
+    for (int i = 0; update_discrete_states().needsUpdate; i++) {
+        if (i == MAX_ITERATIONS) {
+            throw std::runtime_error("Discrete states did not settle after " + std::to_string(MAX_ITERATIONS) + " iterations");
+        }
+    }
+}
+
+void fmu_base::schedule_time_event(double time) {
+    if (time < time_ - 1e-9) {
+        throw std::invalid_argument("Time event at " + std::to_string(time) + " is in the past");
+    }
+    timeEvents_.push(time);
+}
 
+bool fmu_base::do_discrete_update(bool) {
     return false;
 }
 
+RealRange &fmu_base::register_continuous_states(const std::string &name, double *states, double *derivatives, size_t count) {
+    if (nStates_ > 0) {
+        throw std::logic_error("Continuous states have already been registered");
+    }
+    register_real_range(name, states, count)
+            .setVariability(variability_t::CONTINUOUS)
+            .setInitial(initial_t::EXACT);
+    const auto stateIndex = realRanges_.size() - 1;
+    register_real_range("der(" + name + ")", derivatives, count)
+            .setVariability(variability_t::CONTINUOUS)
+            .setInitial(initial_t::CALCULATED)
+            .setDerivativeOf(realRanges_[stateIndex]);
+
+    states_ = states;
+    derivatives_ = derivatives;
+    nStates_ = count;
+    return realRanges_[stateIndex];
+}
+
+void fmu_base::update_derivatives() {
+    throw fatal_error("update_derivatives not implemented by FMU");
+}
+
+void fmu_base::enable_model_exchange() {
+    if (!provides_model_exchange()) {
+        throw std::logic_error("Model Exchange needs continuous states, see register_continuous_states");
+    }
+    modelExchange_ = true;
+    invalidate();
+}
+
+void fmu_base::set_time(double time) {
+    time_ = time;
+    invalidate();
+}
+
+void fmu_base::check_state_count(size_t nx) const {
+    if (nx != nStates_) {
+        throw std::invalid_argument("Expected " + std::to_string(nStates_) + " continuous states, got " + std::to_string(nx));
+    }
+}
+
+void fmu_base::get_continuous_states(double x[], size_t nx) const {
+    check_state_count(nx);
+    std::memcpy(x, states_, nx * sizeof(double));
+}
+
+void fmu_base::set_continuous_states(const double x[], size_t nx) {
+    check_state_count(nx);
+    std::memcpy(states_, x, nx * sizeof(double));
+    invalidate();
+}
+
+void fmu_base::get_derivatives(double dx[], size_t nx) const {
+    check_state_count(nx);
+    refresh();
+    std::memcpy(dx, derivatives_, nx * sizeof(double));
+}
+
+// The instance is only ever const through the accessors, the model itself is not
+void fmu_base::evaluate() const {
+    stale_ = false;
+    const_cast<fmu_base *>(this)->update_derivatives();
+}
+
 void fmu_base::terminate() {}
 
+void fmu_base::finish_initialisation() {
+    exit_initialisation_mode();
+    mode_ = fmu_mode::STEP;
+    if (snapshot_) publish_output_snapshot();
+}
+
+fmu_base::~fmu_base() = default;
+
+void fmu_base::enable_output_snapshot() {
+    if (snapshot_) return;
+
+    auto snapshot = std::make_unique<output_snapshot>();
+    snapshot->slotOf.assign(numVariables_, -1);
+    const auto slot = [&](unsigned int vr) {
+        snapshot->slotOf[vr] = static_cast<int32_t>(snapshot->size);
+        return snapshot->size++;
+    };
+    const auto add = [&](const auto &vars, auto &direct) {
+        for (size_t i = 0; i < vars.size(); i++) {
+            const auto &v = vars[i];
+            if (v.causality() != causality_t::OUTPUT && v.causality() != causality_t::INDEPENDENT) continue;
+            if (const auto ptr = v.ptr()) {
+                direct.push_back({ptr, slot(v.value_reference())});
+            } else {
+                // by index, as registering more variables may reallocate the vector
+                snapshot->computed.emplace_back([&vars, i] { return static_cast<double>(vars[i].get()); },
+                                                slot(v.value_reference()));
+            }
+        }
+    };
+    add(integers_, snapshot->integers);
+    add(reals_, snapshot->reals);
+    add(booleans_, snapshot->booleans);
+    for (const auto &range: realRanges_) {
+        if (range.attributes().causality() != causality_t::OUTPUT) continue;
+        for (size_t i = 0; i < range.size(); i++) {
+            snapshot->reals.push_back({range.ptr(i), slot(range.value_reference() + static_cast<unsigned int>(i))});
+        }
+    }
+    snapshot->values = std::make_unique<std::atomic<double>[]>(snapshot->size);
+
+    snapshot_ = std::move(snapshot);
+    publish_output_snapshot();
+}
+
+void fmu_base::publish_output_snapshot() {
+    auto &snapshot = *snapshot_;
+    const auto seq = snapshot.sequence.load(std::memory_order_relaxed);
+    snapshot.sequence.store(seq + 1, std::memory_order_relaxed);// odd while writing
+    std::atomic_thread_fence(std::memory_order_release);
+    snapshot.store(snapshot.integers);
+    snapshot.store(snapshot.reals);
+    snapshot.store(snapshot.booleans);
+    for (const auto &[source, slot]: snapshot.computed) {
+        snapshot.values[slot].store(source(), std::memory_order_relaxed);
+    }
+    snapshot.sequence.store(seq + 2, std::memory_order_release);
+}
+
+bool fmu_base::read_output_snapshot(const unsigned int vr[], size_t nvr, double values[], double *time) const {
+    if (!snapshot_) return false;
+    const auto &snapshot = *snapshot_;
+
+    for (size_t i = 0; i < nvr; i++) {
+        if (vr[i] >= snapshot.slotOf.size() || snapshot.slotOf[vr[i]] < 0) return false;
+    }
+    const auto timeSlot = snapshot.slotOf[0];
+
+    while (true) {
+        const auto before = snapshot.sequence.load(std::memory_order_acquire);
+        if (before & 1) {// a step is being published, let the writer finish
+            std::this_thread::yield();
+            continue;
+        }
+
+        for (size_t i = 0; i < nvr; i++) {
+            values[i] = snapshot.values[snapshot.slotOf[vr[i]]].load(std::memory_order_relaxed);
+        }
+        if (time) *time = snapshot.values[timeSlot].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (snapshot.sequence.load(std::memory_order_relaxed) == before) return true;
+    }
+}
+
+void fmu_base::reset_instance() {
+    reset();
+    mode_ = fmu_mode::INSTANTIATED;
+}
+
 void fmu_base::reset() {
     if (!state_ops_ || !get_state_ptr_) {
         throw fatal_error("Reset not implemented by FMU");
@@ -99,177 +593,1063 @@ void fmu_base::reset() {
     state_ops_->reset_inplace(dst);
 }
 
-void fmu_base::get_integer(const unsigned int vr[], size_t nvr, int value[]) const {
-    for (unsigned i = 0; i < nvr; i++) {
+unsigned int fmu_base::next_value_reference(const std::string &name, value_type type, size_t index) {
+    const auto vr = static_cast<unsigned int>(numVariables_++);
+    vrTable_.push_back({type, false, static_cast<uint32_t>(index)});
+    nameIndex_.emplace(fnv1a(name), vr);
+    return vr;
+}
+
+namespace {
+
+    // The declared initial attribute, or the FMI default for the causality if there is none
+    std::optional<initial_t> initial_of(const VariableBase &v) {
+        if (v.initial()) return v.initial();
+        switch (v.causality()) {
+            case causality_t::PARAMETER:
+                return initial_t::EXACT;
+            case causality_t::CALCULATED_PARAMETER:
+            case causality_t::OUTPUT:
+            case causality_t::LOCAL:
+                return initial_t::CALCULATED;
+            default:
+                return std::nullopt;// inputs and the independent variable have no initial attribute
+        }
+    }
+
+    // The FMI setter rules: before initialisation, variables with initial exact or approx; during initialisation,
+    // exact ones; after it, tunable parameters. Inputs, whose start value is set like an exact one, in all three.
+    uint8_t settable_modes_of(const VariableBase &v) {
+        using mode = fmu_base::fmu_mode;
+        if (!v.writable() || v.variability() == variability_t::CONSTANT) return 0;
+
+        const auto causality = v.causality();
+        const auto initial = initial_of(v);
+        const bool input = causality == causality_t::INPUT;
+
+        uint8_t modes = 0;
+        if (input || initial == initial_t::EXACT || initial == initial_t::APPROX) {
+            modes |= static_cast<uint8_t>(mode::INSTANTIATED);
+        }
+        if (input || initial == initial_t::EXACT) {
+            modes |= static_cast<uint8_t>(mode::INITIALISATION);
+        }
+        if (input || (causality == causality_t::PARAMETER && v.variability() == variability_t::TUNABLE)) {
+            modes |= static_cast<uint8_t>(mode::STEP);
+        }
+        return modes;
+    }
+
+}// namespace
+
+const std::vector<uint8_t> &fmu_base::settable_modes() const {
+    if (settable_.size() != numVariables_) {
+        settable_.assign(numVariables_, 0);
+        const auto add = [this](const auto &vars) {
+            for (const auto &v: vars) {
+                settable_[v.value_reference()] = settable_modes_of(v);
+            }
+        };
+        add(integers_);
+        add(reals_);
+        add(booleans_);
+        add(strings_);
+        add(binary_);
+        std::apply([&](const auto &...numerics) { (add(numerics.vars), ...); }, numerics_);
+        for (const auto &range: realRanges_) {
+            const auto first = settable_.begin() + range.value_reference();
+            std::fill(first, first + static_cast<std::ptrdiff_t>(range.size()), settable_modes_of(range.attributes()));
+        }
+    }
+    return settable_;
+}
+
+void fmu_base::check_settable(const unsigned int vr[], size_t nvr) const {
+    if constexpr (!checked_access) return;
+
+    const auto &modes = settable_modes();
+    const auto size = modes.size();
+    // accumulate over the whole call, and only look for the culprit if something is off
+    uint8_t ok = static_cast<uint8_t>(mode_);
+    for (size_t i = 0; i < nvr; i++) {
         const auto ref = vr[i];
-        const auto idx = vrToIntegerIndices_.at(ref);
-        value[i] = integers_[idx].get();
+        ok &= ref < size ? modes[ref] : 0;
     }
+    if (!ok) not_settable(vr, nvr);
 }
 
-void fmu_base::get_real(const unsigned int vr[], size_t nvr, double value[]) const {
-    for (unsigned i = 0; i < nvr; i++) {
+void fmu_base::not_settable(const unsigned int vr[], size_t nvr) const {
+    const auto &modes = settable_modes();
+    for (size_t i = 0; i < nvr; i++) {
         const auto ref = vr[i];
-        const auto idx = vrToRealIndices_.at(ref);
-        value[i] = reals_[idx].get();
+        if (ref >= modes.size()) invalid_value_reference(ref);
+        if (!(modes[ref] & static_cast<uint8_t>(mode_))) {
+            if (const auto range = range_of(ref)) {
+                throw std::logic_error("Cannot set value of " + range->element_name(ref - range->value_reference()) +
+                                       " (causality " + to_string(range->attributes().causality()) + ") in the current mode");
+            }
+            const auto predicate = [ref](const VariableBase &v) {
+                return v.value_reference() == ref;
+            };
+            auto variables = collect(integers_, reals_, booleans_, strings_, binary_, predicate);
+            collect_numerics(variables, predicate);
+            const auto &v = *variables.front();
+            throw std::logic_error("Cannot set value of " + v.name() + " (causality " + to_string(v.causality()) +
+                                   ") in the current mode");
+        }
     }
+    throw std::logic_error("Cannot set values in the current mode");
 }
 
-void fmu_base::get_boolean(const unsigned int vr[], size_t nvr, int value[]) const {
-    for (unsigned i = 0; i < nvr; i++) {
+// Used by the per-call get/set paths. Value references are always validated, also in builds
+// with the checks compiled out, which only skip the settable and FMI state checks.
+size_t fmu_base::access_index(unsigned int vr, value_type type) const {
+    return index_of(vr, type);
+}
+
+size_t fmu_base::index_of(unsigned int vr, value_type type) const {
+    if (vr < vrTable_.size()) {
+        const vr_entry entry = vrTable_[vr];
+        if (entry.type == type && !entry.range) return entry.index;
+    }
+    invalid_value_reference(vr);
+}
+
+template<typename T, typename U, typename V>
+void fmu_base::get_values(value_type type, const std::vector<V> &vars, const value_slots<T> &slots,
+                          const unsigned int vr[], size_t nvr, U value[]) const {
+    refresh();
+    size_t i = 0;
+    while (i < nvr) {
         const auto ref = vr[i];
-        const auto idx = vrToBooleanIndices_.at(ref);
-        value[i] = static_cast<int>(booleans_[idx].get());
+        const auto idx = access_index(ref, type);
+        const T *ptr = slots.ptrs[idx];
+        if (!ptr) {
+            const auto getter = slots.getters[idx];
+            value[i++] = static_cast<U>(getter ? getter(const_cast<fmu_base *>(this)) : vars[idx].get());
+            continue;
+        }
+
+        // extend the run while the requested value references map to consecutive memory
+        size_t n = 1;
+        while (i + n < nvr && vr[i + n] == ref + n && idx + n < slots.size() && slots.linked[idx + n]) {
+            ++n;
+        }
+
+        if constexpr (std::is_same_v<T, U>) {
+            if (n > 1) {
+                std::memcpy(value + i, ptr, n * sizeof(T));
+                i += n;
+                continue;
+            }
+        }
+        for (size_t j = 0; j < n; j++) {
+            value[i + j] = static_cast<U>(ptr[j]);
+        }
+        i += n;
     }
 }
 
-void fmu_base::get_boolean(const unsigned int vr[], size_t nvr, bool value[]) const {
-    for (unsigned i = 0; i < nvr; i++) {
+template<typename T, typename U, typename V>
+void fmu_base::set_values(value_type type, std::vector<V> &vars, const value_slots<T> &slots,
+                          const unsigned int vr[], size_t nvr, const U value[]) {
+    check_settable(vr, nvr);
+    invalidate();
+    write_values(type, vars, slots, vr, nvr, value);
+    if (inputStaging_ && nvr > 0) on_inputs_changed(vr, nvr);
+}
+
+template<typename T, typename U, typename V>
+void fmu_base::write_values(value_type type, std::vector<V> &vars, const value_slots<T> &slots,
+                            const unsigned int vr[], size_t nvr, const U value[]) {
+    size_t i = 0;
+    while (i < nvr) {
         const auto ref = vr[i];
-        const auto idx = vrToBooleanIndices_.at(ref);
-        value[i] = booleans_[idx].get();
+        const auto idx = access_index(ref, type);
+        T *ptr = slots.ptrs[idx];
+        auto &var = vars[idx];
+        if (!ptr || (var.hasOnChange() && !inputStaging_)) {
+            var.set_unchecked(static_cast<T>(value[i++]), !inputStaging_);
+            continue;
+        }
+
+        size_t n = 1;
+        while (i + n < nvr && vr[i + n] == ref + n && idx + n < slots.size() && slots.linked[idx + n] &&
+               (inputStaging_ || !vars[idx + n].hasOnChange())) {
+            ++n;
+        }
+
+        if constexpr (std::is_same_v<T, U>) {
+            if (n > 1) {
+                std::memcpy(ptr, value + i, n * sizeof(T));
+                i += n;
+                continue;
+            }
+        }
+        for (size_t j = 0; j < n; j++) {
+            ptr[j] = static_cast<T>(value[i + j]);
+        }
+        i += n;
     }
 }
 
+namespace {
+
+    // The number of values a value reference stands for in fmi3
+    size_t element_count(const VariableBase &v) {
+        const auto array = v.array();
+        return array && v.array_offset() == 0 ? array->size : 1;
+    }
+
+    void check_value_count(size_t required, size_t nValues) {
+        if (checked_access && required > nValues) {
+            throw std::invalid_argument("nValues (" + std::to_string(nValues) + ") is too small for the requested array variables");
+        }
+    }
+
+}// namespace
+
+// Scalars in between arrays are handed to the regular bulk path in stretches,
+// while each array is copied straight from its contiguous storage.
+template<typename T, typename U, typename V>
+size_t fmu_base::get_array_values(value_type type, const std::vector<V> &vars, const value_slots<T> &slots,
+                                  const unsigned int vr[], size_t nvr, U value[], size_t nValues) const {
+    refresh();
+    if (!hasArrays_) {
+        get_values(type, vars, slots, vr, nvr, value);
+        return nvr;
+    }
+
+    size_t i = 0;
+    size_t k = 0;
+    while (i < nvr) {
+        const auto idx = access_index(vr[i], type);
+        const auto n = element_count(vars[idx]);
+        if (n == 1) {
+            size_t j = i + 1;
+            while (j < nvr && element_count(vars[access_index(vr[j], type)]) == 1) ++j;
+            check_value_count(k + j - i, nValues);
+            get_values(type, vars, slots, vr + i, j - i, value + k);
+            k += j - i;
+            i = j;
+            continue;
+        }
+
+        check_value_count(k + n, nValues);
+        const T *ptr = slots.ptrs[idx];
+        if constexpr (std::is_same_v<T, U>) {
+            std::memcpy(value + k, ptr, n * sizeof(T));
+        } else {
+            for (size_t j = 0; j < n; j++) {
+                value[k + j] = static_cast<U>(ptr[j]);
+            }
+        }
+        k += n;
+        ++i;
+    }
+    return k;
+}
+
+template<typename T, typename U, typename V>
+void fmu_base::set_array_values(value_type type, std::vector<V> &vars, const value_slots<T> &slots,
+                                const unsigned int vr[], size_t nvr, const U value[], size_t nValues) {
+    if (!hasArrays_) {
+        set_values(type, vars, slots, vr, nvr, value);
+        return;
+    }
+
+    check_settable(vr, nvr);
+    invalidate();
+    write_array_values(type, vars, slots, vr, nvr, value, nValues);
+    if (inputStaging_ && nvr > 0) on_inputs_changed(vr, nvr);
+}
+
+template<typename T, typename U, typename V>
+size_t fmu_base::write_array_values(value_type type, std::vector<V> &vars, const value_slots<T> &slots,
+                                    const unsigned int vr[], size_t nvr, const U value[], size_t nValues) {
+    size_t i = 0;
+    size_t k = 0;
+    while (i < nvr) {
+        const auto idx = access_index(vr[i], type);
+        const auto n = element_count(vars[idx]);
+        if (n == 1) {
+            size_t j = i + 1;
+            while (j < nvr && element_count(vars[access_index(vr[j], type)]) == 1) ++j;
+            check_value_count(k + j - i, nValues);
+            write_values(type, vars, slots, vr + i, j - i, value + k);
+            k += j - i;
+            i = j;
+            continue;
+        }
+
+        check_value_count(k + n, nValues);
+        T *ptr = slots.ptrs[idx];
+        if constexpr (std::is_same_v<T, U>) {
+            std::memcpy(ptr, value + k, n * sizeof(T));
+        } else {
+            for (size_t j = 0; j < n; j++) {
+                ptr[j] = static_cast<T>(value[k + j]);
+            }
+        }
+        k += n;
+        ++i;
+    }
+    return k;
+}
+
+template<typename F>
+void fmu_base::get_range_values(const unsigned int vr[], size_t nvr, double value[], size_t nValues, F &&other) const {
+    refresh();
+    size_t i = 0;
+    size_t k = 0;
+    while (i < nvr) {
+        const auto range = range_of(vr[i]);
+        if (!range) {
+            size_t j = i + 1;
+            while (j < nvr && !range_of(vr[j])) ++j;
+            k += other(vr + i, j - i, value + k, nValues - k);
+            i = j;
+            continue;
+        }
+
+        const size_t offset = vr[i] - range->value_reference();
+        size_t n = 1;
+        while (i + n < nvr && vr[i + n] == vr[i] + n && offset + n < range->size()) ++n;
+        check_value_count(k + n, nValues);
+        range->read(offset, n, value + k);
+        k += n;
+        i += n;
+    }
+}
+
+template<typename F>
+void fmu_base::write_range_values(const unsigned int vr[], size_t nvr, const double value[], size_t nValues, F &&other) {
+    size_t i = 0;
+    size_t k = 0;
+    while (i < nvr) {
+        const auto range = range_of(vr[i]);
+        if (!range) {
+            size_t j = i + 1;
+            while (j < nvr && !range_of(vr[j])) ++j;
+            k += other(vr + i, j - i, value + k, nValues - k);
+            i = j;
+            continue;
+        }
+
+        const size_t offset = vr[i] - range->value_reference();
+        size_t n = 1;
+        while (i + n < nvr && vr[i + n] == vr[i] + n && offset + n < range->size()) ++n;
+        check_value_count(k + n, nValues);
+        realRanges_[vrTable_[vr[i]].index].write(offset, n, value + k);
+        k += n;
+        i += n;
+    }
+}
+
+void fmu_base::get_integer(const unsigned int vr[], size_t nvr, int value[]) const {
+    get_values(value_type::INTEGER, integers_, integerSlots_, vr, nvr, value);
+}
+
+void fmu_base::get_real(const unsigned int vr[], size_t nvr, double value[]) const {
+    if (hasRanges_) {
+        get_range_values(vr, nvr, value, nvr, [this](const unsigned int *vr, size_t nvr, double *value, size_t) {
+            get_values(value_type::REAL, reals_, realSlots_, vr, nvr, value);
+            return nvr;
+        });
+        return;
+    }
+    get_values(value_type::REAL, reals_, realSlots_, vr, nvr, value);
+}
+
+void fmu_base::get_boolean(const unsigned int vr[], size_t nvr, int value[]) const {
+    get_values(value_type::BOOLEAN, booleans_, booleanSlots_, vr, nvr, value);
+}
+
+void fmu_base::get_boolean(const unsigned int vr[], size_t nvr, bool value[]) const {
+    get_values(value_type::BOOLEAN, booleans_, booleanSlots_, vr, nvr, value);
+}
+
+// Pointer-backed values are handed out straight from the model's storage, which stays valid
+// until the next call into the FMU. Only getter-backed values are copied into the buffers.
 void fmu_base::get_string(const unsigned int vr[], size_t nvr, const char *value[]) {
+    refresh();
     stringBuffer_.clear();
+    stringBuffer_.reserve(nvr);// no reallocation, as that would move (short) strings handed out earlier
     for (unsigned i = 0; i < nvr; i++) {
         const auto ref = vr[i];
-        const auto idx = vrToStringIndices_.at(ref);
-        stringBuffer_.emplace_back(strings_[idx].get());
-        value[i] = stringBuffer_.back().c_str();
+        const auto idx = index_of(ref, value_type::STRING);
+        const auto &var = strings_[idx];
+        if (const auto ptr = var.ptr()) {
+            value[i] = ptr->c_str();
+        } else {
+            value[i] = stringBuffer_.emplace_back(var.get()).c_str();
+        }
     }
 }
 
 void fmu_base::get_binary(const unsigned int vr[], size_t nvr, size_t valueSizes[], const uint8_t *values[]) {
+    refresh();
     binaryBuffer_.clear();
     for (auto i = 0; i < nvr; i++) {
         const auto ref = vr[i];
-        const auto idx = vrToBinaryIndices_.at(ref);
-        const auto &data = binary_[idx].get();
-        valueSizes[i] = data.size();
-        binaryBuffer_.emplace_back(data.begin(), data.end());
-        values[i] = binaryBuffer_.back().data();
+        const auto idx = index_of(ref, value_type::BINARY);
+        const auto &var = binary_[idx];
+        if (const auto ptr = var.ptr()) {
+            valueSizes[i] = ptr->size();
+            values[i] = ptr->data();
+        } else {
+            const auto &data = binaryBuffer_.emplace_back(var.get());
+            valueSizes[i] = data.size();
+            values[i] = data.data();
+        }
     }
 }
 
 void fmu_base::set_integer(const unsigned int vr[], size_t nvr, const int value[]) {
-    for (unsigned i = 0; i < nvr; i++) {
-        const auto ref = vr[i];
-        const auto idx = vrToIntegerIndices_.at(ref);
-        integers_[idx].set(value[i]);
-    }
+    set_values(value_type::INTEGER, integers_, integerSlots_, vr, nvr, value);
 }
 
 void fmu_base::set_real(const unsigned int vr[], size_t nvr, const double value[]) {
-    for (unsigned i = 0; i < nvr; i++) {
-        const auto ref = vr[i];
-        const auto idx = vrToRealIndices_.at(ref);
-        reals_[idx].set(value[i]);
+    if (hasRanges_) {
+        check_settable(vr, nvr);
+        invalidate();
+        write_range_values(vr, nvr, value, nvr, [this](const unsigned int *vr, size_t nvr, const double *value, size_t) {
+            write_values(value_type::REAL, reals_, realSlots_, vr, nvr, value);
+            return nvr;
+        });
+        if (inputStaging_ && nvr > 0) on_inputs_changed(vr, nvr);
+        return;
     }
+    set_values(value_type::REAL, reals_, realSlots_, vr, nvr, value);
 }
+
 void fmu_base::set_boolean(const unsigned int vr[], size_t nvr, const int value[]) {
-    for (unsigned i = 0; i < nvr; i++) {
-        const auto ref = vr[i];
-        const auto idx = vrToBooleanIndices_.at(ref);
-        booleans_[idx].set(static_cast<bool>(value[i]));
-    }
+    set_values(value_type::BOOLEAN, booleans_, booleanSlots_, vr, nvr, value);
 }
+
 void fmu_base::set_boolean(const unsigned int vr[], size_t nvr, const bool value[]) {
-    for (unsigned i = 0; i < nvr; i++) {
-        const auto ref = vr[i];
-        const auto idx = vrToBooleanIndices_.at(ref);
-        booleans_[idx].set(value[i]);
+    set_values(value_type::BOOLEAN, booleans_, booleanSlots_, vr, nvr, value);
+}
+
+void fmu_base::get_integer(const unsigned int vr[], size_t nvr, int value[], size_t nValues) const {
+    get_array_values(value_type::INTEGER, integers_, integerSlots_, vr, nvr, value, nValues);
+}
+
+void fmu_base::get_real(const unsigned int vr[], size_t nvr, double value[], size_t nValues) const {
+    if (hasRanges_) {
+        get_range_values(vr, nvr, value, nValues, [this](const unsigned int *vr, size_t nvr, double *value, size_t nValues) {
+            return get_array_values(value_type::REAL, reals_, realSlots_, vr, nvr, value, nValues);
+        });
+        return;
+    }
+    get_array_values(value_type::REAL, reals_, realSlots_, vr, nvr, value, nValues);
+}
+
+void fmu_base::get_boolean(const unsigned int vr[], size_t nvr, bool value[], size_t nValues) const {
+    get_array_values(value_type::BOOLEAN, booleans_, booleanSlots_, vr, nvr, value, nValues);
+}
+
+void fmu_base::set_integer(const unsigned int vr[], size_t nvr, const int value[], size_t nValues) {
+    set_array_values(value_type::INTEGER, integers_, integerSlots_, vr, nvr, value, nValues);
+}
+
+void fmu_base::set_real(const unsigned int vr[], size_t nvr, const double value[], size_t nValues) {
+    if (hasRanges_) {
+        check_settable(vr, nvr);
+        invalidate();
+        write_range_values(vr, nvr, value, nValues, [this](const unsigned int *vr, size_t nvr, const double *value, size_t nValues) {
+            return write_array_values(value_type::REAL, reals_, realSlots_, vr, nvr, value, nValues);
+        });
+        if (inputStaging_ && nvr > 0) on_inputs_changed(vr, nvr);
+        return;
     }
+    set_array_values(value_type::REAL, reals_, realSlots_, vr, nvr, value, nValues);
+}
+
+void fmu_base::set_boolean(const unsigned int vr[], size_t nvr, const bool value[], size_t nValues) {
+    set_array_values(value_type::BOOLEAN, booleans_, booleanSlots_, vr, nvr, value, nValues);
+}
+
+template<typename T>
+void fmu_base::get_numeric(const unsigned int vr[], size_t nvr, T value[], size_t nValues) const {
+    const auto &n = numerics<T>();
+    get_array_values(type_of<T>(), n.vars, n.slots, vr, nvr, value, nValues);
 }
 
+template<typename T>
+void fmu_base::set_numeric(const unsigned int vr[], size_t nvr, const T value[], size_t nValues) {
+    auto &n = numerics<T>();
+    set_array_values(type_of<T>(), n.vars, n.slots, vr, nvr, value, nValues);
+}
+
+#define FMU4CPP_NUMERIC_ACCESS(T)                                                                                 \
+    template void fmu_base::get_numeric<T>(const unsigned int vr[], size_t nvr, T value[], size_t nValues) const; \
+    template void fmu_base::set_numeric<T>(const unsigned int vr[], size_t nvr, const T value[], size_t nValues); \
+    template VarHandle<T> fmu_base::handle<T>(std::string_view name);
+
+FMU4CPP_NUMERIC_ACCESS(float)
+FMU4CPP_NUMERIC_ACCESS(int8_t)
+FMU4CPP_NUMERIC_ACCESS(uint8_t)
+FMU4CPP_NUMERIC_ACCESS(int16_t)
+FMU4CPP_NUMERIC_ACCESS(uint16_t)
+FMU4CPP_NUMERIC_ACCESS(uint32_t)
+FMU4CPP_NUMERIC_ACCESS(int64_t)
+FMU4CPP_NUMERIC_ACCESS(uint64_t)
+
+#undef FMU4CPP_NUMERIC_ACCESS
+
+template VarHandle<int> fmu_base::handle<int>(std::string_view name);
+template VarHandle<double> fmu_base::handle<double>(std::string_view name);
+template VarHandle<bool> fmu_base::handle<bool>(std::string_view name);
+template VarHandle<std::string> fmu_base::handle<std::string>(std::string_view name);
+template VarHandle<BinaryType> fmu_base::handle<BinaryType>(std::string_view name);
+
 void fmu_base::set_string(const unsigned int vr[], size_t nvr, const char *const value[]) {
+    check_settable(vr, nvr);
+    invalidate();
     for (unsigned i = 0; i < nvr; i++) {
         const auto ref = vr[i];
-        const auto idx = vrToStringIndices_.at(ref);
-        strings_[idx].set(value[i]);
+        const auto idx = index_of(ref, value_type::STRING);
+        strings_[idx].assign_unchecked(value[i], !inputStaging_);
     }
+
+    if (inputStaging_ && nvr > 0) on_inputs_changed(vr, nvr);
 }
 
 void fmu_base::set_binary(const unsigned int vr[], size_t nvr, const size_t valueSizes[], const uint8_t *const value[]) {
+    check_settable(vr, nvr);
+    invalidate();
 
     for (unsigned i = 0; i < nvr; i++) {
         const auto ref = vr[i];
-        const auto idx = vrToBinaryIndices_.at(ref);
-        const uint8_t *ptr = value[i];
-        const size_t len = valueSizes[i];
-        binary_[idx].set(std::vector(ptr, ptr + len));
+        const auto idx = index_of(ref, value_type::BINARY);
+        binary_[idx].assign_unchecked(value[i], valueSizes[i], !inputStaging_);
+    }
+
+    if (inputStaging_ && nvr > 0) on_inputs_changed(vr, nvr);
+}
+
+
+template<typename T, typename V>
+void fmu_base::track_outputs(const std::vector<V> &vars, tracked_outputs<T> &tracked) {
+    for (size_t i = 0; i < vars.size(); i++) {
+        if (vars[i].causality() == causality_t::OUTPUT) {
+            tracked.indices.push_back(static_cast<uint32_t>(i));
+            tracked.shadow.push_back(vars[i].get());
+            tracked.versions.push_back(changeCounter_);
+        }
+    }
+}
+
+template<typename T, typename V>
+void fmu_base::update_tracked(const std::vector<V> &vars, tracked_outputs<T> &tracked) {
+    for (size_t i = 0; i < tracked.indices.size(); i++) {
+        const auto &var = vars[tracked.indices[i]];
+        if (const T *ptr = var.ptr()) {
+            if (*ptr == tracked.shadow[i]) continue;
+            tracked.shadow[i] = *ptr;
+        } else {
+            T value = var.get();
+            if (value == tracked.shadow[i]) continue;
+            tracked.shadow[i] = std::move(value);
+        }
+        tracked.versions[i] = changeCounter_;
+        changedBuffer_.push_back(var.value_reference());
+    }
+}
+
+template<typename T, typename V>
+void fmu_base::collect_changed(const std::vector<V> &vars, const tracked_outputs<T> &tracked,
+                               uint64_t since, std::vector<unsigned int> &vrs) const {
+    for (size_t i = 0; i < tracked.indices.size(); i++) {
+        if (tracked.versions[i] > since) {
+            vrs.push_back(vars[tracked.indices[i]].value_reference());
+        }
+    }
+}
+
+void fmu_base::enable_change_tracking() {
+    if (changeTracking_) return;
+    changeTracking_ = true;
+    changeCounter_ = 1;
+    track_outputs(integers_, trackedIntegers_);
+    track_outputs(reals_, trackedReals_);
+    track_outputs(booleans_, trackedBooleans_);
+    track_outputs(strings_, trackedStrings_);
+    track_outputs(binary_, trackedBinary_);
+    for (const auto &range: realRanges_) {
+        if (range.attributes().causality() != causality_t::OUTPUT) continue;
+        for (size_t i = 0; i < range.size(); i++) {
+            trackedRanges_.indices.push_back(range.value_reference() + static_cast<uint32_t>(i));
+            trackedRanges_.shadow.push_back(*range.ptr(i));
+            trackedRanges_.versions.push_back(changeCounter_);
+        }
+    }
+}
+
+void fmu_base::update_change_tracking() {
+    // every update gets its own version, so that tokens handed out earlier stay comparable
+    ++changeCounter_;
+    changedBuffer_.clear();
+    update_tracked(integers_, trackedIntegers_);
+    update_tracked(reals_, trackedReals_);
+    update_tracked(booleans_, trackedBooleans_);
+    update_tracked(strings_, trackedStrings_);
+    update_tracked(binary_, trackedBinary_);
+    for (size_t i = 0; i < trackedRanges_.indices.size(); i++) {
+        const auto vr = trackedRanges_.indices[i];
+        const auto range = range_of(vr);
+        const double value = *range->ptr(vr - range->value_reference());
+        if (value == trackedRanges_.shadow[i]) continue;
+        trackedRanges_.shadow[i] = value;
+        trackedRanges_.versions[i] = changeCounter_;
+        changedBuffer_.push_back(vr);
+    }
+}
+
+uint64_t fmu_base::changed_outputs(uint64_t since, std::vector<unsigned int> &vrs) {
+    enable_change_tracking();
+    // also picks up changes made outside of a step, e.g. during initialisation or by restoring a state
+    update_change_tracking();
+    collect_changed(integers_, trackedIntegers_, since, vrs);
+    collect_changed(reals_, trackedReals_, since, vrs);
+    collect_changed(booleans_, trackedBooleans_, since, vrs);
+    collect_changed(strings_, trackedStrings_, since, vrs);
+    collect_changed(binary_, trackedBinary_, since, vrs);
+    for (size_t i = 0; i < trackedRanges_.indices.size(); i++) {
+        if (trackedRanges_.versions[i] > since) vrs.push_back(trackedRanges_.indices[i]);
+    }
+    return changeCounter_;
+}
+
+void fmu_base::set_outputs_changed_callback(std::function<void(const unsigned int vr[], size_t nvr)> callback) {
+    enable_change_tracking();
+    outputsChanged_ = std::move(callback);
+}
+
+template<typename T, typename V>
+void fmu_base::prepare_runs(access_plan &plan, const std::vector<V> &vars, const value_slots<T> &slots,
+                            const unsigned int vr[], size_t nvr) const {
+    size_t i = 0;
+    while (i < nvr) {
+        const auto ref = vr[i];
+        const auto idx = index_of(ref, plan.type_);
+        const auto &var = vars[idx];
+        plan.settable_ &= settable_modes()[ref];
+
+        const bool direct = slots.ptrs[idx] && (inputStaging_ || !var.hasOnChange());
+        size_t n = 1;
+        if (direct) {
+            while (i + n < nvr && vr[i + n] == ref + n && idx + n < slots.size() && slots.linked[idx + n] &&
+                   (inputStaging_ || !vars[idx + n].hasOnChange())) {
+                plan.settable_ &= settable_modes()[ref + n];
+                ++n;
+            }
+        }
+        plan.runs_.push_back({static_cast<uint32_t>(idx), static_cast<uint32_t>(n), direct});
+        i += n;
     }
 }
 
+fmu_base::access_plan fmu_base::prepare_access(const unsigned int vr[], size_t nvr) const {
+    access_plan plan;
+    plan.size_ = nvr;
+    plan.vrs_.assign(vr, vr + nvr);
+    if (nvr == 0) return plan;
+
+    if (vr[0] >= vrTable_.size()) invalid_value_reference(vr[0]);
+    plan.type_ = vrTable_[vr[0]].type;
+    for (size_t i = 0; i < nvr; i++) {
+        if (range_of(vr[i])) {
+            throw std::invalid_argument("Prepared access is not supported for the elements of a Real range");
+        }
+    }
+
+    switch (plan.type_) {
+        case value_type::INTEGER:
+            prepare_runs(plan, integers_, integerSlots_, vr, nvr);
+            break;
+        case value_type::REAL:
+            prepare_runs(plan, reals_, realSlots_, vr, nvr);
+            break;
+        case value_type::BOOLEAN:
+            prepare_runs(plan, booleans_, booleanSlots_, vr, nvr);
+            break;
+        default:
+            throw std::invalid_argument("Prepared access is only supported for Integer, Real and Boolean variables");
+    }
+    return plan;
+}
+
+template<typename T, typename U, typename V>
+void fmu_base::get_values(const access_plan &plan, value_type type, const std::vector<V> &vars,
+                          const value_slots<T> &slots, U value[]) const {
+    refresh();
+    if (plan.size_ > 0 && plan.type_ != type) {
+        throw std::invalid_argument("Access plan does not match the requested variable type");
+    }
+    for (const auto &run: plan.runs_) {
+        if (!run.direct) {
+            *value++ = static_cast<U>(vars[run.index].get());
+            continue;
+        }
+        const T *ptr = slots.ptrs[run.index];
+        if constexpr (std::is_same_v<T, U>) {
+            std::memcpy(value, ptr, run.count * sizeof(T));
+        } else {
+            for (size_t j = 0; j < run.count; j++) {
+                value[j] = static_cast<U>(ptr[j]);
+            }
+        }
+        value += run.count;
+    }
+}
+
+template<typename T, typename U, typename V>
+void fmu_base::set_values(const access_plan &plan, value_type type, std::vector<V> &vars,
+                          const value_slots<T> &slots, const U value[]) {
+    if (plan.size_ > 0 && plan.type_ != type) {
+        throw std::invalid_argument("Access plan does not match the requested variable type");
+    }
+    if (!(plan.settable_ & static_cast<uint8_t>(mode_))) {
+        not_settable(plan.vrs_.data(), plan.size_);
+    }
+    invalidate();
+    for (const auto &run: plan.runs_) {
+        if (!run.direct) {
+            vars[run.index].set_unchecked(static_cast<T>(*value++), !inputStaging_);
+            continue;
+        }
+        T *ptr = slots.ptrs[run.index];
+        if constexpr (std::is_same_v<T, U>) {
+            std::memcpy(ptr, value, run.count * sizeof(T));
+        } else {
+            for (size_t j = 0; j < run.count; j++) {
+                ptr[j] = static_cast<T>(value[j]);
+            }
+        }
+        value += run.count;
+    }
+
+    if (inputStaging_ && plan.size_ > 0) on_inputs_changed(plan.vrs_.data(), plan.size_);
+}
+
+void fmu_base::get_integer(const access_plan &plan, int value[]) const {
+    get_values(plan, value_type::INTEGER, integers_, integerSlots_, value);
+}
+
+void fmu_base::get_real(const access_plan &plan, double value[]) const {
+    get_values(plan, value_type::REAL, reals_, realSlots_, value);
+}
+
+void fmu_base::get_boolean(const access_plan &plan, int value[]) const {
+    get_values(plan, value_type::BOOLEAN, booleans_, booleanSlots_, value);
+}
+
+void fmu_base::get_boolean(const access_plan &plan, bool value[]) const {
+    get_values(plan, value_type::BOOLEAN, booleans_, booleanSlots_, value);
+}
+
+void fmu_base::set_integer(const access_plan &plan, const int value[]) {
+    set_values(plan, value_type::INTEGER, integers_, integerSlots_, value);
+}
+
+void fmu_base::set_real(const access_plan &plan, const double value[]) {
+    set_values(plan, value_type::REAL, reals_, realSlots_, value);
+}
+
+void fmu_base::set_boolean(const access_plan &plan, const int value[]) {
+    set_values(plan, value_type::BOOLEAN, booleans_, booleanSlots_, value);
+}
+
+void fmu_base::set_boolean(const access_plan &plan, const bool value[]) {
+    set_values(plan, value_type::BOOLEAN, booleans_, booleanSlots_, value);
+}
 
 IntVariable &fmu_base::register_integer(const std::string &name, int *ptr, const std::function<void()> &onChange) {
-    const auto vr = static_cast<unsigned int>(numVariables_++);
+    const auto vr = next_value_reference(name, value_type::INTEGER, integers_.size());
+    integerSlots_.add(vr, ptr);
     auto &v = integers_.emplace_back(name, vr, numVariables_, ptr, onChange);
-    vrToIntegerIndices_.emplace(v.value_reference(), integers_.size() - 1);
     return v;
 }
 
 IntVariable &fmu_base::register_integer(const std::string &name, const std::function<int()> &getter, const std::optional<std::function<void(int)>> &setter) {
-    const auto vr = static_cast<unsigned int>(numVariables_++);
+    const auto vr = next_value_reference(name, value_type::INTEGER, integers_.size());
+    integerSlots_.add(vr, nullptr);
     auto &v = integers_.emplace_back(name, vr, numVariables_, getter, setter);
-    vrToIntegerIndices_.emplace(v.value_reference(), integers_.size() - 1);
     return v;
 }
 
 RealVariable &fmu_base::register_real(const std::string &name, double *ptr, const std::function<void()> &onChange) {
-    const auto vr = static_cast<unsigned int>(numVariables_++);
+    const auto vr = next_value_reference(name, value_type::REAL, reals_.size());
+    realSlots_.add(vr, ptr);
     auto &v = reals_.emplace_back(name, vr, numVariables_, ptr, onChange);
-    vrToRealIndices_.emplace(v.value_reference(), reals_.size() - 1);
     return v;
 }
 
 RealVariable &fmu_base::register_real(const std::string &name, const std::function<double()> &getter, const std::optional<std::function<void(double)>> &setter) {
-    const auto vr = static_cast<unsigned int>(numVariables_++);
+    const auto vr = next_value_reference(name, value_type::REAL, reals_.size());
+    realSlots_.add(vr, nullptr);
     auto &v = reals_.emplace_back(name, vr, numVariables_, getter, setter);
-    vrToRealIndices_.emplace(v.value_reference(), reals_.size() - 1);
     return v;
 }
 
 BoolVariable &fmu_base::register_boolean(const std::string &name, bool *ptr, const std::function<void()> &onChange) {
-    const auto vr = static_cast<unsigned int>(numVariables_++);
+    const auto vr = next_value_reference(name, value_type::BOOLEAN, booleans_.size());
+    booleanSlots_.add(vr, ptr);
     auto &v = booleans_.emplace_back(name, vr, numVariables_, ptr, onChange);
-    vrToBooleanIndices_.emplace(v.value_reference(), booleans_.size() - 1);
     return v;
 }
 
 BoolVariable &fmu_base::register_boolean(const std::string &name, const std::function<bool()> &getter, const std::optional<std::function<void(bool)>> &setter) {
-    const auto vr = static_cast<unsigned int>(numVariables_++);
+    const auto vr = next_value_reference(name, value_type::BOOLEAN, booleans_.size());
+    booleanSlots_.add(vr, nullptr);
     auto &v = booleans_.emplace_back(name, vr, numVariables_, getter, setter);
-    vrToBooleanIndices_.emplace(v.value_reference(), booleans_.size() - 1);
+    return v;
+}
+
+namespace {
+
+    // name[i,j,...] of the element at the given row-major offset
+    std::string element_name(const std::string &name, const std::vector<size_t> &dimensions, size_t offset) {
+        std::vector<size_t> indices(dimensions.size());
+        for (size_t d = dimensions.size(); d-- > 0;) {
+            indices[d] = offset % dimensions[d];
+            offset /= dimensions[d];
+        }
+        std::string result = name + "[";
+        for (size_t d = 0; d < indices.size(); d++) {
+            if (d > 0) result += ",";
+            result += std::to_string(indices[d]);
+        }
+        return result + "]";
+    }
+
+}// namespace
+
+template<typename V, typename T, typename F>
+VariableArray<V> fmu_base::register_array(const std::string &name, T *data, const std::vector<size_t> &dimensions,
+                                          std::vector<V> &vars, F &&registerElement) {
+    if (!data || dimensions.empty()) {
+        throw std::invalid_argument("Array variable " + name + " requires storage and at least one dimension");
+    }
+    auto info = std::make_shared<VariableBase::array_info>();
+    info->name = name;
+    info->dimensions = dimensions;
+    info->size = 1;
+    for (const auto d: dimensions) info->size *= d;
+    if (info->size == 0) {
+        throw std::invalid_argument("Array variable " + name + " has no elements");
+    }
+
+    // consecutive value references over consecutive memory, so the elements end up linked in the value slots
+    const auto first = vars.size();
+    vars.reserve(first + info->size);
+    for (size_t i = 0; i < info->size; i++) {
+        auto &v = registerElement(element_name(name, dimensions, i), data + i);
+        v.array_ = info;
+        v.arrayOffset_ = i;
+    }
+    hasArrays_ = true;
+    return {vars, first, info->size};
+}
+
+VariableArray<IntVariable> fmu_base::register_integer_array(const std::string &name, int *data, const std::vector<size_t> &dimensions) {
+    return register_array(name, data, dimensions, integers_, [this](const std::string &element, int *ptr) -> IntVariable & {
+        return register_integer(element, ptr);
+    });
+}
+
+VariableArray<RealVariable> fmu_base::register_real_array(const std::string &name, double *data, const std::vector<size_t> &dimensions) {
+    return register_array(name, data, dimensions, reals_, [this](const std::string &element, double *ptr) -> RealVariable & {
+        return register_real(element, ptr);
+    });
+}
+
+VariableArray<BoolVariable> fmu_base::register_boolean_array(const std::string &name, bool *data, const std::vector<size_t> &dimensions) {
+    return register_array(name, data, dimensions, booleans_, [this](const std::string &element, bool *ptr) -> BoolVariable & {
+        return register_boolean(element, ptr);
+    });
+}
+
+// No RealVariable per element, and no entry in the name index either: an element only costs its vrTable_ entry.
+RealRange &fmu_base::register_real_range(const std::string &name, double *base, size_t count, size_t stride) {
+    if (!base || count == 0 || stride == 0) {
+        throw std::invalid_argument("Real range " + name + " requires storage, at least one element and a non-zero stride");
+    }
+    const auto vr = static_cast<unsigned int>(numVariables_);
+    vrTable_.resize(numVariables_ + count, {value_type::REAL, true, static_cast<uint32_t>(realRanges_.size())});
+    numVariables_ += count;
+    hasRanges_ = true;
+    return realRanges_.emplace_back(name, vr, base, count, stride);
+}
+
+std::vector<RealVariable> fmu_base::range_elements() const {
+    size_t count = 0;
+    for (const auto &range: realRanges_) count += range.size();
+    std::vector<RealVariable> elements;
+    elements.reserve(count);
+    for (const auto &range: realRanges_) {
+        for (size_t i = 0; i < range.size(); i++) {
+            elements.emplace_back(range.element(i));
+        }
+    }
+    return elements;
+}
+
+void fmu_base::collect_ranges(std::vector<const VariableBase *> &vars, const std::vector<RealVariable> &elements,
+                              const std::function<bool(const VariableBase &)> &predicate) {
+    for (const auto &v: elements) {
+        if (predicate(v)) vars.push_back(&v);
+    }
+}
+
+template<typename T>
+NumericVariable<T> &fmu_base::register_numeric(const std::string &name, T *ptr, const std::function<void()> &onChange) {
+    auto &n = numerics<T>();
+    const auto vr = next_value_reference(name, type_of<T>(), n.vars.size());
+    n.slots.add(vr, ptr);
+    return n.vars.emplace_back(name, vr, numVariables_, ptr, onChange);
+}
+
+template<typename T>
+NumericVariable<T> &fmu_base::register_numeric(const std::string &name, const std::function<T()> &getter, const std::optional<std::function<void(T)>> &setter) {
+    auto &n = numerics<T>();
+    const auto vr = next_value_reference(name, type_of<T>(), n.vars.size());
+    n.slots.add(vr, nullptr);
+    return n.vars.emplace_back(name, vr, numVariables_, getter, setter);
+}
+
+Float32Variable &fmu_base::register_float32(const std::string &name, float *ptr, const std::function<void()> &onChange) {
+    return register_numeric(name, ptr, onChange);
+}
+
+Float32Variable &fmu_base::register_float32(const std::string &name, const std::function<float()> &getter, const std::optional<std::function<void(float)>> &setter) {
+    return register_numeric(name, getter, setter);
+}
+
+Int8Variable &fmu_base::register_int8(const std::string &name, int8_t *ptr, const std::function<void()> &onChange) {
+    return register_numeric(name, ptr, onChange);
+}
+
+Int8Variable &fmu_base::register_int8(const std::string &name, const std::function<int8_t()> &getter, const std::optional<std::function<void(int8_t)>> &setter) {
+    return register_numeric(name, getter, setter);
+}
+
+UInt8Variable &fmu_base::register_uint8(const std::string &name, uint8_t *ptr, const std::function<void()> &onChange) {
+    return register_numeric(name, ptr, onChange);
+}
+
+UInt8Variable &fmu_base::register_uint8(const std::string &name, const std::function<uint8_t()> &getter, const std::optional<std::function<void(uint8_t)>> &setter) {
+    return register_numeric(name, getter, setter);
+}
+
+Int16Variable &fmu_base::register_int16(const std::string &name, int16_t *ptr, const std::function<void()> &onChange) {
+    return register_numeric(name, ptr, onChange);
+}
+
+Int16Variable &fmu_base::register_int16(const std::string &name, const std::function<int16_t()> &getter, const std::optional<std::function<void(int16_t)>> &setter) {
+    return register_numeric(name, getter, setter);
+}
+
+UInt16Variable &fmu_base::register_uint16(const std::string &name, uint16_t *ptr, const std::function<void()> &onChange) {
+    return register_numeric(name, ptr, onChange);
+}
+
+UInt16Variable &fmu_base::register_uint16(const std::string &name, const std::function<uint16_t()> &getter, const std::optional<std::function<void(uint16_t)>> &setter) {
+    return register_numeric(name, getter, setter);
+}
+
+UInt32Variable &fmu_base::register_uint32(const std::string &name, uint32_t *ptr, const std::function<void()> &onChange) {
+    return register_numeric(name, ptr, onChange);
+}
+
+UInt32Variable &fmu_base::register_uint32(const std::string &name, const std::function<uint32_t()> &getter, const std::optional<std::function<void(uint32_t)>> &setter) {
+    return register_numeric(name, getter, setter);
+}
+
+Int64Variable &fmu_base::register_int64(const std::string &name, int64_t *ptr, const std::function<void()> &onChange) {
+    return register_numeric(name, ptr, onChange);
+}
+
+Int64Variable &fmu_base::register_int64(const std::string &name, const std::function<int64_t()> &getter, const std::optional<std::function<void(int64_t)>> &setter) {
+    return register_numeric(name, getter, setter);
+}
+
+UInt64Variable &fmu_base::register_uint64(const std::string &name, uint64_t *ptr, const std::function<void()> &onChange) {
+    return register_numeric(name, ptr, onChange);
+}
+
+UInt64Variable &fmu_base::register_uint64(const std::string &name, const std::function<uint64_t()> &getter, const std::optional<std::function<void(uint64_t)>> &setter) {
+    return register_numeric(name, getter, setter);
+}
+
+void fmu_base::collect_numerics(std::vector<const VariableBase *> &vars, const std::function<bool(const VariableBase &)> &predicate) const {
+    std::apply([&](const auto &...numerics) {
+        const auto add = [&](const auto &numeric) {
+            for (const auto &v: numeric.vars) {
+                if (predicate(v)) vars.push_back(&v);
+            }
+        };
+        (add(numerics), ...);
+    },
+               numerics_);
+}
+
+IntVariable &fmu_base::register_bound_integer(const std::string &name, bound_getter<int> getter, bound_setter<int> setter) {
+    const auto vr = next_value_reference(name, value_type::INTEGER, integers_.size());
+    integerSlots_.add(vr, nullptr, getter);
+    auto &v = integers_.emplace_back(name, vr, numVariables_, this, getter, setter);
+    return v;
+}
+
+RealVariable &fmu_base::register_bound_real(const std::string &name, bound_getter<double> getter, bound_setter<double> setter) {
+    const auto vr = next_value_reference(name, value_type::REAL, reals_.size());
+    realSlots_.add(vr, nullptr, getter);
+    auto &v = reals_.emplace_back(name, vr, numVariables_, this, getter, setter);
+    return v;
+}
+
+BoolVariable &fmu_base::register_bound_boolean(const std::string &name, bound_getter<bool> getter, bound_setter<bool> setter) {
+    const auto vr = next_value_reference(name, value_type::BOOLEAN, booleans_.size());
+    booleanSlots_.add(vr, nullptr, getter);
+    auto &v = booleans_.emplace_back(name, vr, numVariables_, this, getter, setter);
     return v;
 }
 
 StringVariable &fmu_base::register_string(const std::string &name, std::string *ptr, const std::function<void()> &onChange) {
-    const auto vr = static_cast<unsigned int>(numVariables_++);
+    const auto vr = next_value_reference(name, value_type::STRING, strings_.size());
     auto &v = strings_.emplace_back(name, vr, numVariables_, ptr, onChange);
-    vrToStringIndices_.emplace(v.value_reference(), strings_.size() - 1);
     return v;
 }
 
 StringVariable &fmu_base::register_string(const std::string &name, const std::function<std::string()> &getter, const std::optional<std::function<void(std::string)>> &setter) {
-    const auto vr = static_cast<unsigned int>(numVariables_++);
+    const auto vr = next_value_reference(name, value_type::STRING, strings_.size());
+    auto &v = strings_.emplace_back(name, vr, numVariables_, getter, setter);
+    return v;
+}
+
+StringVariable &fmu_base::register_string_view(const std::string &name, const std::function<std::string()> &getter, const std::function<void(std::string_view)> &setter) {
+    const auto vr = next_value_reference(name, value_type::STRING, strings_.size());
     auto &v = strings_.emplace_back(name, vr, numVariables_, getter, setter);
-    vrToStringIndices_.emplace(v.value_reference(), strings_.size() - 1);
     return v;
 }
 
 BinaryVariable &fmu_base::register_binary(const std::string &name, BinaryType *ptr, const std::function<void()> &onChange) {
-    const auto vr = static_cast<unsigned int>(numVariables_++);
+    const auto vr = next_value_reference(name, value_type::BINARY, binary_.size());
     auto &v = binary_.emplace_back(name, vr, numVariables_, ptr, onChange);
-    vrToBinaryIndices_.emplace(v.value_reference(), binary_.size() - 1);
     return v;
 }
 
 BinaryVariable &fmu_base::register_binary(const std::string &name, const std::function<BinaryType()> &getter, const std::optional<std::function<void(BinaryType)>> &setter) {
-    const auto vr = static_cast<unsigned int>(numVariables_++);
+    const auto vr = next_value_reference(name, value_type::BINARY, binary_.size());
+    auto &v = binary_.emplace_back(name, vr, numVariables_, getter, setter);
+    return v;
+}
+
+BinaryVariable &fmu_base::register_binary_view(const std::string &name, const std::function<BinaryType()> &getter, const std::function<void(const uint8_t *, size_t)> &setter) {
+    const auto vr = next_value_reference(name, value_type::BINARY, binary_.size());
     auto &v = binary_.emplace_back(name, vr, numVariables_, getter, setter);
-    vrToBinaryIndices_.emplace(v.value_reference(), binary_.size() - 1);
     return v;
 }
 
@@ -287,7 +1667,8 @@ BinaryVariable &fmu_base::register_binary(const std::string &name, const std::fu
         ss << str;
     }
 
-    const auto vars = collect(integers_, reals_, booleans_, strings_);
+    auto vars = collect(integers_, reals_, booleans_, strings_);
+    collect_numerics(vars);
     for (const auto &v: vars) {
         ss << v->name();
         ss << std::to_string(v->index());
@@ -300,6 +1681,17 @@ BinaryVariable &fmu_base::register_binary(const std::string &name, const std::fu
             ss << to_string(*v->initial());
         }
     }
+    // ranges contribute as a whole, so that instantiating does not have to create their elements
+    for (const auto &range: realRanges_) {
+        const auto &v = range.attributes();
+        ss << range.name() << range.size() << range.value_reference() << to_string(v.causality());
+        if (v.variability()) {
+            ss << to_string(*v.variability());
+        }
+        if (v.initial()) {
+            ss << to_string(*v.initial());
+        }
+    }
 
     return std::to_string(fnv1a(ss.str()));
 }
@@ -312,11 +1704,17 @@ void fmu_base::debugLog(const fmiStatus s, const std::string &message) const {
 
 std::vector<unsigned> fmu_base::get_value_refs() const {
     std::vector<unsigned int> indices;
-    const auto allVars = collect(integers_, reals_, booleans_, strings_);
+    auto allVars = collect(integers_, reals_, booleans_, strings_);
+    collect_numerics(allVars);
     indices.reserve(allVars.size());
     for (const auto &v: allVars) {
         indices.emplace_back(v->value_reference());
     }
+    for (const auto &range: realRanges_) {
+        for (size_t i = 0; i < range.size(); i++) {
+            indices.emplace_back(range.value_reference() + static_cast<unsigned int>(i));
+        }
+    }
 
     return indices;
 }
@@ -332,6 +1730,7 @@ void fmu_base::setFmuState(void *state) {
     if (!state_ops_ || !get_state_ptr_) throw fatal_error("setFmuState not implemented");
     void *dst = get_state_ptr_(this);
     state_ops_->assign_into_state(dst, state);
+    invalidate();
 }
 
 void fmu_base::freeFmuState(void **state) {
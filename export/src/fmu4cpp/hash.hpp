@@ -3,11 +3,11 @@
 #define FMU4CPP_TEMPLATE_HASH_HPP
 
 #include <cstdint>
-#include <string>
+#include <string_view>
 
 
 //https://stackoverflow.com/questions/66764096/calculating-stdhash-using-different-compilers
-inline uint64_t fnv1a(std::string const &text) {
+inline uint64_t fnv1a(std::string_view text) {
 
     if constexpr (sizeof(void *) == 4) {
         // 32-bit environment
@@ -3,14 +3,25 @@
 #define FMU4CPP_UTIL_HPP
 
 #include <functional>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 #include "fmu4cpp/fmu_base.hpp"
+#include "fmu4cpp/vendor_extensions.h"
 
 
 namespace fmu4cpp {
 
+    // FMUs generated with UNCHECKED (see generateFMU) trust the importer to follow the model description
+    // and the FMI state machine, and skip the per-call validation. Debug builds always validate.
+#if defined(FMU4CPP_UNCHECKED) && defined(NDEBUG)
+    constexpr bool checked_access = false;
+#else
+    constexpr bool checked_access = true;
+#endif
+
     inline std::vector<const VariableBase *> collect(
             const std::vector<IntVariable> &v1,
             const std::vector<RealVariable> &v2,
@@ -60,6 +71,91 @@ namespace fmu4cpp {
         return indentedString;
     }
 
+    // The two halves of fmu4cppExchangeStep, around the version specific step
+    inline void set_step_inputs(fmu_base &slave, const fmu4cppStepValues &inputs) {
+        if (inputs.nReal > 0) slave.set_real(inputs.realVr, inputs.nReal, inputs.realValues);
+        if (inputs.nInteger > 0) slave.set_integer(inputs.integerVr, inputs.nInteger, inputs.integerValues);
+        if (inputs.nBoolean > 0) slave.set_boolean(inputs.booleanVr, inputs.nBoolean, inputs.booleanValues);
+        if (inputs.nString > 0) slave.set_string(inputs.stringVr, inputs.nString, inputs.stringValues);
+    }
+
+    inline void get_step_outputs(fmu_base &slave, const fmu4cppStepValues &outputs) {
+        if (outputs.nReal > 0) slave.get_real(outputs.realVr, outputs.nReal, outputs.realValues);
+        if (outputs.nInteger > 0) slave.get_integer(outputs.integerVr, outputs.nInteger, outputs.integerValues);
+        if (outputs.nBoolean > 0) slave.get_boolean(outputs.booleanVr, outputs.nBoolean, outputs.booleanValues);
+        if (outputs.nString > 0) slave.get_string(outputs.stringVr, outputs.nString, outputs.stringValues);
+    }
+
+    // The inputs and outputs of fmu4cppDoSteps, around the version specific step, resolved once for the whole series
+    class step_series {
+
+    public:
+        step_series(const fmu_base &slave, const fmu4cppStepSeries *series, size_t nSteps) {
+            if (!series) return;
+            if (series->nInputs > 0) {
+                if (series->inputStride != 0 && series->inputStride < series->nInputs) {
+                    throw std::invalid_argument("The input stride must be 0 or at least the number of inputs");
+                }
+                inputs_ = prepare_reals(slave, series->inputVr, series->nInputs);
+                values_ = series->inputValues;
+                inputStride_ = series->inputStride;
+            }
+            if (series->nOutputs > 0) {
+                if (nSteps > 1 && series->outputStride < series->nOutputs) {
+                    throw std::invalid_argument("The output stride must be at least the number of outputs");
+                }
+                outputs_ = prepare_reals(slave, series->outputVr, series->nOutputs);
+                results_ = series->outputValues;
+                outputStride_ = series->outputStride;
+            }
+        }
+
+        void set_inputs(fmu_base &slave, size_t step) const {
+            // constant inputs are set before the first step only
+            if (inputs_ && (inputStride_ != 0 || step == 0)) {
+                slave.set_real(*inputs_, values_ + step * inputStride_);
+            }
+        }
+
+        void get_outputs(const fmu_base &slave, size_t step) const {
+            if (outputs_) slave.get_real(*outputs_, results_ + step * outputStride_);
+        }
+
+    private:
+        // checked up front, so that a series does not fail after some of its steps
+        static fmu_base::access_plan prepare_reals(const fmu_base &slave, const unsigned int vr[], size_t nvr) {
+            auto plan = slave.prepare_access(vr, nvr);
+            if (plan.type() != fmu_base::value_type::REAL) {
+                throw std::invalid_argument("A step series only exchanges Real variables");
+            }
+            return plan;
+        }
+
+        std::optional<fmu_base::access_plan> inputs_;
+        const double *values_{nullptr};
+        size_t inputStride_{0};
+
+        std::optional<fmu_base::access_plan> outputs_;
+        double *results_{nullptr};
+        size_t outputStride_{0};
+    };
+
+    // Functions exported in addition to the FMI API, see fmu4cpp/vendor_extensions.h
+    inline std::vector<std::string> vendor_extensions() {
+        return {"fmu4cppPrepareAccess", "fmu4cppGetChangedOutputs", "fmu4cppSetOutputsChangedCallback",
+                "fmu4cppEnableOutputSnapshot", "fmu4cppReadOutputSnapshot", "fmu4cppExchangeStep",
+                "fmu4cppDoSteps"};
+    }
+
+    inline std::string vendor_tool_annotation() {
+        std::string xml = "<Tool name=\"fmu4cpp\">\n";
+        for (const auto &name: vendor_extensions()) {
+            xml += "\t<Extension name=\"" + name + "\"/>\n";
+        }
+        xml += "</Tool>";
+        return xml;
+    }
+
 }// namespace fmu4cpp
 
 #endif//FMU4CPP_UTIL_HPP
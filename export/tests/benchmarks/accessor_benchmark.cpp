@@ -0,0 +1,88 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <fmu4cpp/fmu_base.hpp>
+
+#include <numeric>
+#include <vector>
+
+// Computed outputs read through std::function getters versus getters bound at compile time,
+// and a single variable read by value reference versus through a typed handle.
+class Model : public fmu4cpp::fmu_base {
+
+public:
+    Model(fmu4cpp::fmu_data data, size_t numVariables)
+        : fmu_base(std::move(data)) {
+
+        for (size_t i = 0; i < numVariables; i++) {
+            register_real("lambda[" + std::to_string(i) + "]", [this] { return scaled(); })
+                    .setCausality(fmu4cpp::causality_t::OUTPUT);
+        }
+        for (size_t i = 0; i < numVariables; i++) {
+            register_real<&Model::scaled>("bound[" + std::to_string(i) + "]")
+                    .setCausality(fmu4cpp::causality_t::OUTPUT);
+        }
+        register_real("state", &value_)
+                .setCausality(fmu4cpp::causality_t::OUTPUT);
+    }
+
+    bool do_step(double dt) override {
+        return true;
+    }
+
+    void reset() override {}
+
+private:
+    double value_{1};
+
+    [[nodiscard]] double scaled() const {
+        return 2 * value_;
+    }
+};
+
+fmu4cpp::model_info fmu4cpp::get_model_info() {
+    return {};
+}
+
+std::string fmu4cpp::model_identifier() {
+    return "accessor_benchmark";
+}
+
+std::unique_ptr<fmu4cpp::fmu_base> fmu4cpp::createInstance(const fmu_data &data) {
+    return std::make_unique<Model>(data, 0);
+}
+
+TEST_CASE("accessor_benchmark") {
+
+    constexpr size_t numVariables = 1000;
+    Model model({}, numVariables);
+
+    // time is vr 0, followed by the lambda backed and then the bound variables
+    std::vector<unsigned int> lambdaVrs(numVariables);
+    std::iota(lambdaVrs.begin(), lambdaVrs.end(), 1);
+    std::vector<unsigned int> boundVrs(numVariables);
+    std::iota(boundVrs.begin(), boundVrs.end(), 1 + numVariables);
+    std::vector<double> values(numVariables);
+
+    BENCHMARK("get_real std::function getters, 1000 variables") {
+        model.get_real(lambdaVrs.data(), lambdaVrs.size(), values.data());
+        return values.front();
+    };
+
+    BENCHMARK("get_real bound getters, 1000 variables") {
+        model.get_real(boundVrs.data(), boundVrs.size(), values.data());
+        return values.front();
+    };
+
+    const unsigned int stateVr = 1 + 2 * numVariables;
+    BENCHMARK("get_real by value reference, 1 variable") {
+        double value;
+        model.get_real(&stateVr, 1, &value);
+        return value;
+    };
+
+    const auto state = model.handle<double>("state");
+    BENCHMARK("VarHandle::get, 1 variable") {
+        return state.get();
+    };
+}
@@ -0,0 +1,156 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <fmu4cpp/fmu_base.hpp>
+
+#include "fmi3/fmi3Functions.h"
+#include "fmu4cpp/vendor_extensions.h"
+
+#include <numeric>
+#include <vector>
+
+// Measures the per-call overhead of the FMI3 entry points for small transfers, where validation dominates.
+// Built twice, as fmi3_call_benchmark and fmi3_call_benchmark_unchecked (see UNCHECKED in generateFMU).
+// The unchecked variant only differs in Release-type builds, as UNCHECKED has no effect without NDEBUG.
+
+class Model : public fmu4cpp::fmu_base {
+
+public:
+    FMU4CPP_CTOR(Model), inputs_(8), outputs_(8) {
+
+        for (size_t i = 0; i < inputs_.size(); i++) {
+            register_real("input[" + std::to_string(i) + "]", &inputs_[i])
+                    .setCausality(fmu4cpp::causality_t::INPUT);
+        }
+        for (size_t i = 0; i < outputs_.size(); i++) {
+            register_real("output[" + std::to_string(i) + "]", &outputs_[i])
+                    .setCausality(fmu4cpp::causality_t::OUTPUT);
+        }
+    }
+
+    bool do_step(double dt) override {
+        for (size_t i = 0; i < inputs_.size(); i++) {
+            outputs_[i] = inputs_[i] * dt;
+        }
+        return true;
+    }
+
+private:
+    std::vector<double> inputs_;
+    std::vector<double> outputs_;
+};
+
+fmu4cpp::model_info fmu4cpp::get_model_info() {
+    return {};
+}
+
+std::string fmu4cpp::model_identifier() {
+    return "fmi3_call_benchmark";
+}
+
+FMU4CPP_INSTANTIATE(Model);
+
+void fmilogger(fmi3InstanceEnvironment, fmi3Status, fmi3String, fmi3String) {}
+
+TEST_CASE("fmi3_call_benchmark") {
+
+    Model model({});
+    const auto guid = model.guid();
+
+    const auto c = fmi3InstantiateCoSimulation("fmi3_call_benchmark", guid.c_str(), "", false, false, false, false, nullptr, 0, nullptr, fmilogger, nullptr);
+    REQUIRE(c);
+    REQUIRE(fmi3EnterInitializationMode(c, false, 0, 0, false, 0) == fmi3OK);
+    REQUIRE(fmi3ExitInitializationMode(c) == fmi3OK);
+
+    // time is vr 0, followed by the inputs and the outputs
+    std::vector<fmi3ValueReference> inputs(8);
+    std::iota(inputs.begin(), inputs.end(), 1);
+    std::vector<fmi3ValueReference> outputs(8);
+    std::iota(outputs.begin(), outputs.end(), 9);
+    // every other input, so that the values are not copied in one go
+    const std::vector<fmi3ValueReference> scattered{1, 3, 5, 7};
+    std::vector<double> values(8, 1.0);
+
+    BENCHMARK("fmi3GetFloat64, 1 value") {
+        double value;
+        fmi3GetFloat64(c, outputs.data(), 1, &value, 1);
+        return value;
+    };
+
+    BENCHMARK("fmi3GetFloat64, 8 values") {
+        fmi3GetFloat64(c, outputs.data(), outputs.size(), values.data(), values.size());
+        return values.front();
+    };
+
+    BENCHMARK("fmi3SetFloat64, 1 value") {
+        return fmi3SetFloat64(c, inputs.data(), 1, values.data(), 1);
+    };
+
+    BENCHMARK("fmi3SetFloat64, 4 scattered values") {
+        return fmi3SetFloat64(c, scattered.data(), scattered.size(), values.data(), scattered.size());
+    };
+
+    double t = 0;
+    const double dt = 0.001;
+    BENCHMARK("fmi3DoStep") {
+        bool eventHandlingNeeded, terminateSimulation, earlyReturn;
+        double lastSuccessfulTime;
+        fmi3DoStep(c, t, dt, false, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime);
+        t = lastSuccessfulTime;
+        return t;
+    };
+
+    BENCHMARK("fmi3SetFloat64 + fmi3DoStep + fmi3GetFloat64, 8 values") {
+        bool eventHandlingNeeded, terminateSimulation, earlyReturn;
+        double lastSuccessfulTime;
+        fmi3SetFloat64(c, inputs.data(), inputs.size(), values.data(), values.size());
+        fmi3DoStep(c, t, dt, false, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime);
+        fmi3GetFloat64(c, outputs.data(), outputs.size(), values.data(), values.size());
+        t = lastSuccessfulTime;
+        return t;
+    };
+
+    fmu4cppStepValues in{};
+    in.realVr = inputs.data();
+    in.nReal = inputs.size();
+    in.realValues = values.data();
+    fmu4cppStepValues out{};
+    out.realVr = outputs.data();
+    out.nReal = outputs.size();
+    out.realValues = values.data();
+    BENCHMARK("fmu4cppExchangeStep, 8 values") {
+        fmu4cppExchangeStep(c, &in, t, dt, &out, &t, nullptr, nullptr);
+        return t;
+    };
+
+    // the same 1000 steps, one call each or in a single call
+    constexpr size_t nSteps = 1000;
+    std::vector<double> recorded(nSteps * outputs.size());
+    BENCHMARK("1000 x (fmi3SetFloat64 + fmi3DoStep + fmi3GetFloat64), 8 values") {
+        bool eventHandlingNeeded, terminateSimulation, earlyReturn;
+        double lastSuccessfulTime;
+        for (size_t k = 0; k < nSteps; k++) {
+            fmi3SetFloat64(c, inputs.data(), inputs.size(), values.data(), values.size());
+            fmi3DoStep(c, t, dt, false, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime);
+            fmi3GetFloat64(c, outputs.data(), outputs.size(), &recorded[k * outputs.size()], outputs.size());
+            t = lastSuccessfulTime;
+        }
+        return t;
+    };
+
+    fmu4cppStepSeries series{};
+    series.inputVr = inputs.data();
+    series.nInputs = inputs.size();
+    series.inputValues = values.data();
+    series.outputVr = outputs.data();
+    series.nOutputs = outputs.size();
+    series.outputValues = recorded.data();
+    series.outputStride = outputs.size();
+    BENCHMARK("fmu4cppDoSteps, 1000 steps, 8 values") {
+        size_t nCompleted;
+        fmu4cppDoSteps(c, t, dt, nSteps, &series, &nCompleted, &t);
+        return t;
+    };
+
+    fmi3FreeInstance(c);
+}
@@ -0,0 +1,78 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <fmu4cpp/fmu_base.hpp>
+
+#include <numeric>
+#include <vector>
+
+// Instantiating a model with a large flattened signal vector, registered one variable at a time versus as a Real range,
+// and reading the whole vector back.
+class Model : public fmu4cpp::fmu_base {
+
+public:
+    Model(fmu4cpp::fmu_data data, size_t numSignals, bool range)
+        : fmu_base(std::move(data)), signals_(numSignals) {
+
+        if (range) {
+            register_real_range("sig", signals_.data(), signals_.size())
+                    .setCausality(fmu4cpp::causality_t::OUTPUT);
+            return;
+        }
+        for (size_t i = 0; i < signals_.size(); i++) {
+            register_real("sig[" + std::to_string(i) + "]", &signals_[i])
+                    .setCausality(fmu4cpp::causality_t::OUTPUT);
+        }
+    }
+
+    bool do_step(double dt) override {
+        return true;
+    }
+
+    void reset() override {}
+
+private:
+    std::vector<double> signals_;
+};
+
+fmu4cpp::model_info fmu4cpp::get_model_info() {
+    return {};
+}
+
+std::string fmu4cpp::model_identifier() {
+    return "range_benchmark";
+}
+
+std::unique_ptr<fmu4cpp::fmu_base> fmu4cpp::createInstance(const fmu_data &data) {
+    return std::make_unique<Model>(data, 0, false);
+}
+
+TEST_CASE("range_benchmark") {
+
+    constexpr size_t numSignals = 20000;
+
+    BENCHMARK("instantiate, 20000 register_real") {
+        return Model({}, numSignals, false).guid();
+    };
+
+    BENCHMARK("instantiate, register_real_range") {
+        return Model({}, numSignals, true).guid();
+    };
+
+    // time is vr 0, followed by the signals
+    std::vector<unsigned int> vrs(numSignals);
+    std::iota(vrs.begin(), vrs.end(), 1);
+    std::vector<double> values(numSignals);
+
+    Model scalars({}, numSignals, false);
+    BENCHMARK("get_real 20000 scalars") {
+        scalars.get_real(vrs.data(), vrs.size(), values.data());
+        return values.front();
+    };
+
+    Model range({}, numSignals, true);
+    BENCHMARK("get_real 20000 range elements") {
+        range.get_real(vrs.data(), vrs.size(), values.data());
+        return values.front();
+    };
+}
@@ -0,0 +1,125 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <fmu4cpp/fmu_base.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+class Model : public fmu4cpp::fmu_base {
+
+public:
+    Model(fmu4cpp::fmu_data data, size_t numVariables)
+        : fmu_base(std::move(data)), reals_(numVariables), integers_(numVariables) {
+
+        for (size_t i = 0; i < numVariables; i++) {
+            register_real("real[" + std::to_string(i) + "]", &reals_[i])
+                    .setCausality(fmu4cpp::causality_t::PARAMETER)
+                    .setVariability(fmu4cpp::variability_t::TUNABLE);
+        }
+        for (size_t i = 0; i < numVariables; i++) {
+            register_integer("integer[" + std::to_string(i) + "]", &integers_[i])
+                    .setCausality(fmu4cpp::causality_t::PARAMETER)
+                    .setVariability(fmu4cpp::variability_t::TUNABLE);
+        }
+    }
+
+    bool do_step(double dt) override {
+        return true;
+    }
+
+    void reset() override {}
+
+private:
+    std::vector<double> reals_;
+    std::vector<int> integers_;
+};
+
+fmu4cpp::model_info fmu4cpp::get_model_info() {
+    return {};
+}
+
+std::string fmu4cpp::model_identifier() {
+    return "vr_lookup_benchmark";
+}
+
+std::unique_ptr<fmu4cpp::fmu_base> fmu4cpp::createInstance(const fmu_data &data) {
+    return std::make_unique<Model>(data, 0);
+}
+
+namespace {
+
+    void run_benchmarks(size_t numVariables) {
+        Model model({}, numVariables);
+
+        // time is vr 0, followed by the block of reals
+        std::vector<unsigned int> realVrs(numVariables);
+        std::iota(realVrs.begin(), realVrs.end(), 1);
+        std::vector<unsigned int> shuffledVrs(realVrs);
+        std::shuffle(shuffledVrs.begin(), shuffledVrs.end(), std::mt19937(42));
+        std::vector<double> values(numVariables);
+
+        const auto n = std::to_string(numVariables);
+
+        BENCHMARK("get_real single, " + n + " variables") {
+            double sum = 0;
+            for (const auto vr: realVrs) {
+                double value;
+                model.get_real(&vr, 1, &value);
+                sum += value;
+            }
+            return sum;
+        };
+
+        BENCHMARK("get_real bulk, " + n + " variables") {
+            model.get_real(realVrs.data(), realVrs.size(), values.data());
+            return values.front();
+        };
+
+        BENCHMARK("get_real bulk scattered, " + n + " variables") {
+            model.get_real(shuffledVrs.data(), shuffledVrs.size(), values.data());
+            return values.front();
+        };
+
+        BENCHMARK("set_real bulk, " + n + " variables") {
+            model.set_real(realVrs.data(), realVrs.size(), values.data());
+            return values.front();
+        };
+
+        BENCHMARK("set_real bulk scattered, " + n + " variables") {
+            model.set_real(shuffledVrs.data(), shuffledVrs.size(), values.data());
+            return values.front();
+        };
+
+        const auto lastName = "real[" + std::to_string(numVariables - 1) + "]";
+
+        BENCHMARK("get_real_variable by name, " + n + " variables") {
+            return model.get_real_variable(lastName)->value_reference();
+        };
+
+        BENCHMARK("find_real_variable by name, " + n + " variables") {
+            return model.find_real_variable(lastName)->value_reference();
+        };
+
+        const auto plan = model.prepare_access(shuffledVrs.data(), shuffledVrs.size());
+
+        BENCHMARK("get_real prepared scattered, " + n + " variables") {
+            model.get_real(plan, values.data());
+            return values.front();
+        };
+
+        BENCHMARK("set_real prepared scattered, " + n + " variables") {
+            model.set_real(plan, values.data());
+            return values.front();
+        };
+    }
+
+}// namespace
+
+TEST_CASE("vr_lookup_benchmark") {
+    run_benchmarks(10);
+    run_benchmarks(1000);
+    run_benchmarks(100000);
+}
@@ -0,0 +1,119 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <fmu4cpp/fmu_base.hpp>
+
+class Model : public fmu4cpp::fmu_base {
+
+public:
+    FMU4CPP_CTOR(Model) {
+
+        register_real<&Model::gain, &Model::setGain>("gain")
+                .setCausality(fmu4cpp::causality_t::PARAMETER)
+                .setVariability(fmu4cpp::variability_t::TUNABLE);
+        register_real<&Model::height>("height")
+                .setCausality(fmu4cpp::causality_t::OUTPUT);
+        register_integer<&steps>("steps")
+                .setCausality(fmu4cpp::causality_t::OUTPUT);
+        register_boolean<&Model::enabled, &setEnabled>("enabled")
+                .setCausality(fmu4cpp::causality_t::INPUT);
+        register_real<&Model::offset>("offset")
+                .setCausality(fmu4cpp::causality_t::INPUT);
+    }
+
+    bool do_step(double dt) override {
+        if (enabled_) {
+            height_ += gain_ * dt;
+            ++steps_;
+        }
+        return true;
+    }
+
+    void reset() override {}
+
+private:
+    double gain_{1};
+    double height_{0};
+    int steps_{0};
+    bool enabled_{true};
+
+    [[nodiscard]] double gain() const {
+        return gain_;
+    }
+
+    void setGain(double gain) {
+        gain_ = gain;
+    }
+
+    [[nodiscard]] double height() const {
+        return height_;
+    }
+
+    [[nodiscard]] double offset() const {
+        return 0;
+    }
+
+    [[nodiscard]] bool enabled() const {
+        return enabled_;
+    }
+
+    static int steps(const Model &model) {
+        return model.steps_;
+    }
+
+    static void setEnabled(Model &model, bool enabled) {
+        model.enabled_ = enabled;
+    }
+};
+
+fmu4cpp::model_info fmu4cpp::get_model_info() {
+    return {};
+}
+
+std::string fmu4cpp::model_identifier() {
+    return "bound_accessor";
+}
+
+FMU4CPP_INSTANTIATE(Model);
+
+
+TEST_CASE("bound accessors") {
+
+    Model model({});
+
+    // time is vr 0, followed by the variables in order of registration
+    const unsigned int gain = 1, height = 2, steps = 3, enabled = 4;
+
+    const double newGain = 2;
+    model.set_real(&gain, 1, &newGain);
+    model.finish_initialisation();
+
+    REQUIRE(model.step(0, 0.5));
+    REQUIRE(model.step(0.5, 0.5));
+
+    const unsigned int reals[] = {gain, height};
+    double values[2];
+    model.get_real(reals, 2, values);
+    CHECK(values[0] == 2);
+    CHECK(values[1] == 2);
+
+    int stepCount;
+    model.get_integer(&steps, 1, &stepCount);
+    CHECK(stepCount == 2);
+
+    const bool disabled = false;
+    model.set_boolean(&enabled, 1, &disabled);
+    bool enabledValue;
+    model.get_boolean(&enabled, 1, &enabledValue);
+    CHECK_FALSE(enabledValue);
+
+    REQUIRE(model.step(1, 0.5));
+    model.get_integer(&steps, 1, &stepCount);
+    CHECK(stepCount == 2);
+
+    // read-only accessors cannot be set
+    CHECK_THROWS(model.set_real(&height, 1, &newGain));
+
+    // neither can writable variables registered without a setter, instead of silently dropping the value
+    const unsigned int offset = 5;
+    CHECK_THROWS_AS(model.set_real(&offset, 1, &newGain), std::logic_error);
+}
@@ -0,0 +1,481 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <fmu4cpp/fmu_base.hpp>
+
+#include <vector>
+
+class Model : public fmu4cpp::fmu_base {
+
+public:
+    FMU4CPP_CTOR(Model), reals_(9), gap_(2) {
+
+        // vr 1-4 are contiguous in memory
+        for (int i = 0; i < 4; i++) {
+            register_real("real[" + std::to_string(i) + "]", &reals_[i])
+                    .setCausality(fmu4cpp::causality_t::PARAMETER)
+                    .setVariability(fmu4cpp::variability_t::TUNABLE);
+        }
+        // vr 5 is backed by a getter/setter pair
+        register_real(
+                "lambda",
+                [this] { return lambda_; },
+                [this](double value) { lambda_ = value; })
+                .setCausality(fmu4cpp::causality_t::PARAMETER)
+                .setVariability(fmu4cpp::variability_t::TUNABLE);
+        // vr 6-7 are contiguous, vr 8 is not
+        register_real("real[4]", &reals_[4])
+                .setCausality(fmu4cpp::causality_t::PARAMETER)
+                .setVariability(fmu4cpp::variability_t::TUNABLE);
+        register_real("real[5]", &reals_[5])
+                .setCausality(fmu4cpp::causality_t::PARAMETER)
+                .setVariability(fmu4cpp::variability_t::TUNABLE);
+        register_real("real[7]", &reals_[7])
+                .setCausality(fmu4cpp::causality_t::PARAMETER)
+                .setVariability(fmu4cpp::variability_t::TUNABLE);
+        // vr 9 is contiguous in memory with vr 8, but is an output
+        register_real("output", &reals_[8])
+                .setCausality(fmu4cpp::causality_t::OUTPUT);
+        // vr 10-11 are integers
+        register_integer("integer[0]", &integers_[0])
+                .setCausality(fmu4cpp::causality_t::INPUT);
+        register_integer("integer[1]", &integers_[1])
+                .setCausality(fmu4cpp::causality_t::INPUT);
+        // vr 12 has an onChange hook
+        register_real("hooked", &gap_[0], [this] { ++changes_; })
+                .setCausality(fmu4cpp::causality_t::INPUT);
+        // vr 13-16 are strings and binaries, backed by pointers and by getter/setter pairs
+        register_string("text", &text_)
+                .setCausality(fmu4cpp::causality_t::INPUT);
+        register_string(
+                "textLambda",
+                [this] { return text_; },
+                [this](const std::string &value) { text_ = value; })
+                .setCausality(fmu4cpp::causality_t::INPUT);
+        register_binary("blob", &blob_)
+                .setCausality(fmu4cpp::causality_t::INPUT);
+        register_binary(
+                "blobLambda",
+                [this] { return blob_; },
+                [this](const fmu4cpp::BinaryType &value) { blob_ = value; })
+                .setCausality(fmu4cpp::causality_t::INPUT);
+        // vr 17-18 have setters taking views
+        register_string_view(
+                "textView",
+                [this] { return text_; },
+                [this](std::string_view value) { text_.assign(value); ++changes_; })
+                .setCausality(fmu4cpp::causality_t::INPUT);
+        register_binary_view(
+                "blobView",
+                [this] { return blob_; },
+                [this](const uint8_t *data, size_t size) { blob_.assign(data, data + size); ++changes_; })
+                .setCausality(fmu4cpp::causality_t::INPUT);
+        // vr 19 can only be set before the simulation starts
+        register_real("fixed", &fixed_)
+                .setCausality(fmu4cpp::causality_t::PARAMETER)
+                .setVariability(fmu4cpp::variability_t::FIXED);
+        // vr 20 is calculated from the parameters, vr 21 only has a guess before initialisation
+        register_real("calculated", &calculated_)
+                .setCausality(fmu4cpp::causality_t::CALCULATED_PARAMETER)
+                .setVariability(fmu4cpp::variability_t::FIXED);
+        register_real("guess", &guess_)
+                .setCausality(fmu4cpp::causality_t::PARAMETER)
+                .setVariability(fmu4cpp::variability_t::FIXED)
+                .setInitial(fmu4cpp::initial_t::APPROX);
+
+        Model::reset();
+    }
+
+    bool do_step(double dt) override {
+        return true;
+    }
+
+    void reset() override {
+        for (size_t i = 0; i < reals_.size(); i++) {
+            reals_[i] = static_cast<double>(i);
+        }
+        lambda_ = -1;
+    }
+
+    int changes_{0};
+    std::string text_;
+    fmu4cpp::BinaryType blob_;
+    double fixed_{};
+    double calculated_{};
+    double guess_{};
+
+private:
+    std::vector<double> reals_;
+    std::vector<double> gap_;
+    double lambda_{};
+    int integers_[2]{};
+};
+
+class StagedModel : public fmu4cpp::fmu_base {
+
+public:
+    FMU4CPP_CTOR(StagedModel), inputs_(4) {
+
+        set_input_staging(true);
+        for (int i = 0; i < 4; i++) {
+            register_real("input[" + std::to_string(i) + "]", &inputs_[i], [this] { ++changes_; })
+                    .setCausality(fmu4cpp::causality_t::INPUT);
+        }
+        register_string("text", &text_, [this] { ++changes_; })
+                .setCausality(fmu4cpp::causality_t::INPUT);
+    }
+
+    bool do_step(double dt) override {
+        return true;
+    }
+
+    void reset() override {}
+
+    void on_inputs_changed(const unsigned int vr[], size_t nvr) override {
+        batches_.emplace_back(vr, vr + nvr);
+    }
+
+    int changes_{0};
+    std::vector<std::vector<unsigned int>> batches_;
+    std::vector<double> inputs_;
+    std::string text_;
+};
+
+fmu4cpp::model_info fmu4cpp::get_model_info() {
+    return {};
+}
+
+std::string fmu4cpp::model_identifier() {
+    return "bulk_access";
+}
+
+FMU4CPP_INSTANTIATE(Model);
+
+
+TEST_CASE("bulk get") {
+
+    Model model({});
+
+    const std::vector<unsigned int> vrs{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::vector<double> values(vrs.size());
+    model.get_real(vrs.data(), vrs.size(), values.data());
+    CHECK(values == std::vector<double>{0, 1, 2, 3, -1, 4, 5, 7, 8});
+
+    const std::vector<unsigned int> scattered{9, 4, 1, 5, 3, 8, 2};
+    values.resize(scattered.size());
+    model.get_real(scattered.data(), scattered.size(), values.data());
+    CHECK(values == std::vector<double>{8, 3, 0, -1, 2, 7, 1});
+
+    const std::vector<unsigned int> mixed{1, 2, 10};
+    CHECK_THROWS(model.get_real(mixed.data(), mixed.size(), values.data()));
+}
+
+TEST_CASE("bulk set") {
+
+    Model model({});
+
+    const std::vector<unsigned int> vrs{1, 2, 3, 4, 5, 6, 7, 8};
+    const std::vector<double> values{10, 11, 12, 13, 14, 15, 16, 17};
+    model.set_real(vrs.data(), vrs.size(), values.data());
+
+    std::vector<double> read(vrs.size());
+    model.get_real(vrs.data(), vrs.size(), read.data());
+    CHECK(read == values);
+
+    const std::vector<unsigned int> scattered{7, 2, 5};
+    const std::vector<double> scatteredValues{20, 21, 22};
+    model.set_real(scattered.data(), scattered.size(), scatteredValues.data());
+    model.get_real(scattered.data(), scattered.size(), read.data());
+    CHECK(std::vector<double>(read.begin(), read.begin() + 3) == scatteredValues);
+
+    // the run 8-9 ends in an output, which must not be written
+    const std::vector<unsigned int> withOutput{8, 9};
+    CHECK_THROWS(model.set_real(withOutput.data(), withOutput.size(), values.data()));
+    double output;
+    const unsigned int outputVr = 9;
+    model.get_real(&outputVr, 1, &output);
+    CHECK(output == 8);
+
+    const std::vector<unsigned int> integerVrs{10, 11};
+    const std::vector<int> integers{3, 4};
+    model.set_integer(integerVrs.data(), integerVrs.size(), integers.data());
+    std::vector<int> readIntegers(2);
+    model.get_integer(integerVrs.data(), integerVrs.size(), readIntegers.data());
+    CHECK(readIntegers == integers);
+
+    const unsigned int hookedVr = 12;
+    const double hooked = 1;
+    model.set_real(&hookedVr, 1, &hooked);
+    CHECK(model.changes_ == 1);
+}
+
+TEST_CASE("prepared access") {
+
+    Model model({});
+
+    const std::vector<unsigned int> vrs{1, 2, 3, 4, 5, 6, 7, 12};
+    const auto plan = model.prepare_access(vrs.data(), vrs.size());
+    CHECK(plan.type() == fmu4cpp::fmu_base::value_type::REAL);
+    CHECK(plan.size() == vrs.size());
+
+    std::vector<double> values(vrs.size());
+    model.get_real(plan, values.data());
+    CHECK(values == std::vector<double>{0, 1, 2, 3, -1, 4, 5, 0});
+
+    const std::vector<double> newValues{10, 11, 12, 13, 14, 15, 16, 17};
+    model.set_real(plan, newValues.data());
+    model.get_real(plan, values.data());
+    CHECK(values == newValues);
+    CHECK(model.changes_ == 1);
+
+    // wrong type for the plan
+    std::vector<int> integers(vrs.size());
+    CHECK_THROWS(model.get_integer(plan, integers.data()));
+
+    const std::vector<unsigned int> mixed{1, 2, 10};
+    CHECK_THROWS(model.prepare_access(mixed.data(), mixed.size()));
+    const std::vector<unsigned int> invalid{1, 999};
+    CHECK_THROWS(model.prepare_access(invalid.data(), invalid.size()));
+
+    // plans containing an output can be read, but not written
+    const std::vector<unsigned int> withOutput{8, 9};
+    const auto outputPlan = model.prepare_access(withOutput.data(), withOutput.size());
+    model.get_real(outputPlan, values.data());
+    CHECK(values[1] == 8);
+    CHECK_THROWS(model.set_real(outputPlan, newValues.data()));
+    model.get_real(outputPlan, values.data());
+    CHECK(values[0] == 7);
+}
+
+TEST_CASE("string and binary get") {
+
+    Model model({});
+    model.text_ = "a string that does not fit the small string buffer";
+    model.blob_ = {1, 2, 3};
+
+    const std::vector<unsigned int> stringVrs{13, 14};
+    const char *strings[2];
+    model.get_string(stringVrs.data(), stringVrs.size(), strings);
+    // pointer-backed values are not copied
+    CHECK(strings[0] == model.text_.c_str());
+    CHECK(strings[1] != model.text_.c_str());
+    CHECK(std::string(strings[1]) == model.text_);
+
+    const std::vector<unsigned int> binaryVrs{15, 16};
+    size_t sizes[2];
+    const uint8_t *blobs[2];
+    model.get_binary(binaryVrs.data(), binaryVrs.size(), sizes, blobs);
+    CHECK(blobs[0] == model.blob_.data());
+    CHECK(blobs[1] != model.blob_.data());
+    CHECK(sizes[0] == 3);
+    CHECK(sizes[1] == 3);
+    CHECK(std::vector<uint8_t>(blobs[1], blobs[1] + sizes[1]) == model.blob_);
+}
+
+TEST_CASE("string and binary set") {
+
+    Model model({});
+
+    const unsigned int textVr = 13;
+    const char *text = "a string that does not fit the small string buffer";
+    model.set_string(&textVr, 1, &text);
+    CHECK(model.text_ == text);
+
+    // shorter values are assigned into the existing storage
+    const char *storage = model.text_.data();
+    const char *shorter = "a shorter string";
+    model.set_string(&textVr, 1, &shorter);
+    CHECK(model.text_ == shorter);
+    CHECK(model.text_.data() == storage);
+
+    const unsigned int blobVr = 15;
+    const std::vector<uint8_t> blob{1, 2, 3, 4};
+    const uint8_t *blobData = blob.data();
+    size_t blobSize = blob.size();
+    model.set_binary(&blobVr, 1, &blobSize, &blobData);
+    CHECK(model.blob_ == blob);
+
+    const uint8_t *blobStorage = model.blob_.data();
+    blobSize = 2;
+    model.set_binary(&blobVr, 1, &blobSize, &blobData);
+    CHECK(model.blob_ == std::vector<uint8_t>{1, 2});
+    CHECK(model.blob_.data() == blobStorage);
+
+    // setting a value to itself
+    const uint8_t *self;
+    model.get_binary(&blobVr, 1, &blobSize, &self);
+    model.set_binary(&blobVr, 1, &blobSize, &self);
+    CHECK(model.blob_ == std::vector<uint8_t>{1, 2});
+
+    const std::vector<unsigned int> lambdaVrs{14, 16};
+    const char *viaCopy = "copy";
+    model.set_string(&lambdaVrs[0], 1, &viaCopy);
+    CHECK(model.text_ == "copy");
+    blobSize = blob.size();
+    model.set_binary(&lambdaVrs[1], 1, &blobSize, &blobData);
+    CHECK(model.blob_ == blob);
+
+    const unsigned int textViewVr = 17;
+    const char *viaView = "view";
+    model.set_string(&textViewVr, 1, &viaView);
+    CHECK(model.text_ == "view");
+    const unsigned int blobViewVr = 18;
+    blobSize = 1;
+    model.set_binary(&blobViewVr, 1, &blobSize, &blobData);
+    CHECK(model.blob_ == std::vector<uint8_t>{1});
+    CHECK(model.changes_ == 2);
+}
+
+TEST_CASE("input staging") {
+
+    StagedModel model({});
+
+    const std::vector<unsigned int> vrs{1, 2, 3, 4};
+    const std::vector<double> values{1, 2, 3, 4};
+    model.set_real(vrs.data(), vrs.size(), values.data());
+    CHECK(model.inputs_ == values);
+    CHECK(model.changes_ == 0);
+    REQUIRE(model.batches_.size() == 1);
+    CHECK(model.batches_[0] == vrs);
+
+    const std::vector<unsigned int> subset{4, 2};
+    const auto plan = model.prepare_access(subset.data(), subset.size());
+    model.set_real(plan, values.data());
+    CHECK(model.inputs_ == std::vector<double>{1, 2, 3, 1});
+    REQUIRE(model.batches_.size() == 2);
+    CHECK(model.batches_[1] == subset);
+
+    const unsigned int textVr = 5;
+    const char *text = "staged";
+    model.set_string(&textVr, 1, &text);
+    CHECK(model.text_ == "staged");
+    CHECK(model.changes_ == 0);
+    CHECK(model.batches_.size() == 3);
+
+    // values set through a typed handle are staged the same way
+    model.handle<double>("input[2]").set(5);
+    CHECK(model.inputs_[2] == 5);
+    CHECK(model.changes_ == 0);
+    REQUIRE(model.batches_.size() == 4);
+    CHECK(model.batches_[3] == std::vector<unsigned int>{3});
+}
+
+TEST_CASE("find variable by name") {
+
+    Model model({});
+
+    const auto real = model.find_real_variable(std::string_view("real[7]"));
+    REQUIRE(real);
+    CHECK(real->value_reference() == 8);
+    CHECK(model.get_real_variable("real[7]")->value_reference() == 8);
+
+    REQUIRE(model.find_int_variable("integer[1]"));
+    CHECK(model.find_int_variable("integer[1]")->value_reference() == 11);
+    CHECK(model.find_string_variable("textView")->value_reference() == 17);
+    CHECK(model.find_binary_variable("blob")->value_reference() == 15);
+    CHECK(model.find_real_variable("time")->value_reference() == 0);
+
+    // names are looked up per type
+    CHECK_FALSE(model.find_int_variable("real[7]"));
+    CHECK_FALSE(model.find_real_variable("unknown"));
+    CHECK_FALSE(model.get_real_variable("unknown"));
+}
+
+TEST_CASE("settable per mode") {
+
+    Model model({});
+    CHECK(model.mode() == fmu4cpp::fmu_base::fmu_mode::INSTANTIATED);
+
+    const std::vector<unsigned int> vrs{19, 1, 10};
+    const std::vector<double> reals{1, 2, 3};
+    const std::vector<int> integers{4};
+    model.set_real(vrs.data(), 2, reals.data());
+    CHECK(model.fixed_ == 1);
+
+    model.enter_initialisation_mode(0, std::nullopt, std::nullopt);
+    model.set_real(vrs.data(), 2, reals.data());
+    model.finish_initialisation();
+    CHECK(model.mode() == fmu4cpp::fmu_base::fmu_mode::STEP);
+
+    // fixed parameters cannot be set once initialised, and nothing of a rejected call is applied
+    const std::vector<double> newReals{5, 6};
+    CHECK_THROWS(model.set_real(vrs.data(), 2, newReals.data()));
+    CHECK(model.fixed_ == 1);
+    double real;
+    model.get_real(&vrs[1], 1, &real);
+    CHECK(real == 2);
+
+    // tunable parameters and inputs can
+    model.set_real(&vrs[1], 1, newReals.data());
+    model.set_integer(&vrs[2], 1, integers.data());
+
+    const auto plan = model.prepare_access(vrs.data(), 2);
+    CHECK_THROWS(model.set_real(plan, newReals.data()));
+
+    model.reset_instance();
+    CHECK(model.mode() == fmu4cpp::fmu_base::fmu_mode::INSTANTIATED);
+    model.set_real(plan, newReals.data());
+    CHECK(model.fixed_ == 5);
+}
+
+TEST_CASE("settable per initial") {
+
+    Model model({});
+
+    const unsigned int calculated = 20, guess = 21;
+    const double value = 1;
+
+    // calculated parameters are never set by the importer
+    CHECK_THROWS(model.set_real(&calculated, 1, &value));
+    // approximate values only before initialisation
+    model.set_real(&guess, 1, &value);
+    CHECK(model.guess_ == 1);
+
+    model.enter_initialisation_mode(0, std::nullopt, std::nullopt);
+    CHECK_THROWS(model.set_real(&calculated, 1, &value));
+    CHECK_THROWS(model.set_real(&guess, 1, &value));
+    const auto plan = model.prepare_access(&calculated, 1);
+    CHECK_THROWS(model.set_real(plan, &value));
+    model.finish_initialisation();
+
+    CHECK_THROWS(model.set_real(&calculated, 1, &value));
+    CHECK(model.calculated_ == 0);
+}
+
+TEST_CASE("typed handles") {
+
+    Model model({});
+
+    const auto real = model.handle<double>("real[2]");
+    REQUIRE(real);
+    CHECK(real.value_reference() == 3);
+    CHECK(real.get() == 2);
+
+    auto lambda = model.handle<double>("lambda");
+    CHECK(lambda.get() == -1);
+    lambda.set(3);
+    const auto vr = lambda.value_reference();
+    double value;
+    model.get_real(&vr, 1, &value);
+    CHECK(value == 3);
+
+    auto integer = model.handle(*model.find_int_variable("integer[1]"));
+    integer.set(7);
+    CHECK(integer.get() == 7);
+
+    auto text = model.handle<std::string>("text");
+    text.set("handle");
+    CHECK(model.text_ == "handle");
+
+    // the causality rules still apply, and names are looked up per type
+    auto output = model.handle<double>("output");
+    CHECK(output.get() == 8);
+    CHECK_THROWS(output.set(1));
+    // as do the settable modes
+    auto guess = model.handle<double>("guess");
+    guess.set(2);
+    model.enter_initialisation_mode(0, std::nullopt, std::nullopt);
+    CHECK_THROWS(guess.set(3));
+    CHECK(model.guess_ == 2);
+    CHECK_THROWS(model.handle<int>("real[2]"));
+    CHECK_FALSE(fmu4cpp::VarHandle<double>());
+}
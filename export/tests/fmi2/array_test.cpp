@@ -16,15 +16,9 @@ class Model : public fmu4cpp::fmu_base {
 public:
     FMU4CPP_CTOR(Model), reals_(4) {
 
-        for (int i = 0; i < reals_.size(); i++) {
-            // clang-format off
-            register_real("real[" + std::to_string(i) + "]",
-                [this, i] { return reals_[i]; },
-                [this, i](double val) { reals_[i] = val; }
-                ).setCausality(fmu4cpp::causality_t::PARAMETER)
-            .setVariability(fmu4cpp::variability_t::TUNABLE);
-            // clang-format on
-        }
+        register_real_array("real", reals_.data(), {reals_.size()})
+                .setCausality(fmu4cpp::causality_t::PARAMETER)
+                .setVariability(fmu4cpp::variability_t::TUNABLE);
 
         Model::reset();
     }
@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <iostream>
+#include <vector>
+
+#include <fmu4cpp/fmu_base.hpp>
+#include <fmu4cpp/vendor_extensions.h>
+
+#include "Identity.hpp"
+#include "fmi2/fmi2Functions.h"
+
+
+std::string fmu4cpp::model_identifier() {
+    return "identity";
+}
+
+void fmilogger(fmi2Component, fmi2String instanceName, fmi2Status status, fmi2String /*category*/, fmi2String message, ...) {
+    std::cerr << instanceName << ": " << message << std::endl;
+}
+
+void onOutputsChanged(void *environment, const unsigned int vr[], size_t nvr) {
+    static_cast<std::vector<unsigned int> *>(environment)->assign(vr, vr + nvr);
+}
+
+TEST_CASE("test_change_tracking") {
+
+    Model model({});
+    const auto guid = model.guid();
+
+    const auto realIn = model.get_real_variable("realIn")->value_reference();
+    const auto realOut = model.get_real_variable("realOut")->value_reference();
+
+    fmi2CallbackFunctions callbackFunctions;
+    callbackFunctions.logger = &fmilogger;
+
+    const auto c = fmi2Instantiate("identity", fmi2CoSimulation, guid.c_str(), "", &callbackFunctions, false, true);
+    REQUIRE(c);
+
+    REQUIRE(fmi2SetupExperiment(c, false, 0, 0, false, 0) == fmi2OK);
+    REQUIRE(fmi2EnterInitializationMode(c) == fmi2OK);
+    REQUIRE(fmi2ExitInitializationMode(c) == fmi2OK);
+
+    std::vector<unsigned int> reported;
+    REQUIRE(fmu4cppSetOutputsChangedCallback(c, &onOutputsChanged, &reported) == fmiOK);
+
+    uint64_t token = 0;
+    std::vector<unsigned int> changed(4);
+    size_t nChanged;
+
+    // too small a buffer
+    REQUIRE(fmu4cppGetChangedOutputs(c, &token, changed.data(), 1, &nChanged) == fmiDiscard);
+    REQUIRE(nChanged == 4);
+    REQUIRE(token == 0);
+
+    // all outputs on the first read
+    REQUIRE(fmu4cppGetChangedOutputs(c, &token, changed.data(), changed.size(), &nChanged) == fmiOK);
+    REQUIRE(nChanged == 4);
+    REQUIRE(token != 0);
+
+    const double value = 2;
+    REQUIRE(fmi2SetReal(c, &realIn, 1, &value) == fmi2OK);
+    REQUIRE(fmi2DoStep(c, 0, 0.1, true) == fmi2OK);
+    REQUIRE(reported == std::vector<unsigned int>{realOut});
+
+    REQUIRE(fmu4cppGetChangedOutputs(c, &token, changed.data(), changed.size(), &nChanged) == fmiOK);
+    REQUIRE(nChanged == 1);
+    REQUIRE(changed[0] == realOut);
+
+    reported.clear();
+    REQUIRE(fmi2DoStep(c, 0.1, 0.1, true) == fmi2OK);
+    REQUIRE(reported.empty());
+
+    REQUIRE(fmu4cppGetChangedOutputs(c, &token, changed.data(), changed.size(), &nChanged) == fmiOK);
+    REQUIRE(nChanged == 0);
+
+    REQUIRE(fmi2Terminate(c) == fmi2OK);
+    fmi2FreeInstance(c);
+}
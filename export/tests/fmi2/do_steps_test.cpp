@@ -0,0 +1,124 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+#include <fmu4cpp/fmu_base.hpp>
+#include <fmu4cpp/vendor_extensions.h>
+
+#include "Identity.hpp"
+#include "fmi2/fmi2Functions.h"
+
+
+std::string fmu4cpp::model_identifier() {
+    return "identity";
+}
+
+void fmilogger(fmi2Component, fmi2String instanceName, fmi2Status status, fmi2String /*category*/, fmi2String message, ...) {
+    std::cerr << instanceName << ": " << message << std::endl;
+}
+
+TEST_CASE("test_do_steps") {
+
+    Model model({});
+    const auto guid = model.guid();
+
+    const unsigned int realIn = model.find_real_variable("realIn")->value_reference();
+    const unsigned int realOut = model.find_real_variable("realOut")->value_reference();
+
+    fmi2CallbackFunctions callbackFunctions;
+    callbackFunctions.logger = &fmilogger;
+
+    const auto c = fmi2Instantiate("identity", fmi2CoSimulation, guid.c_str(), "", &callbackFunctions, false, false);
+    REQUIRE(c);
+
+    REQUIRE(fmi2SetupExperiment(c, false, 0, 0, true, 0.95) == fmi2OK);
+    REQUIRE(fmi2EnterInitializationMode(c) == fmi2OK);
+    REQUIRE(fmi2ExitInitializationMode(c) == fmi2OK);
+
+    constexpr size_t nSteps = 5;
+    std::vector<double> inputs(nSteps);
+    std::iota(inputs.begin(), inputs.end(), 1.0);
+    const unsigned int outputVrs[]{0, realOut};// time is vr 0
+    std::vector<double> outputs(2 * nSteps);
+
+    fmu4cppStepSeries series{};
+    series.inputVr = &realIn;
+    series.nInputs = 1;
+    series.inputValues = inputs.data();
+    series.inputStride = 1;
+    series.outputVr = outputVrs;
+    series.nOutputs = 2;
+    series.outputValues = outputs.data();
+    series.outputStride = 2;
+
+    size_t nCompleted;
+    double time;
+    REQUIRE(fmu4cppDoSteps(c, 0, 0.1, nSteps, &series, &nCompleted, &time) == fmiOK);
+    REQUIRE(nCompleted == nSteps);
+    REQUIRE(time == Catch::Approx(0.5));
+    for (size_t k = 0; k < nSteps; k++) {
+        CHECK(outputs[2 * k] == Catch::Approx(0.1 * static_cast<double>(k + 1)));
+        CHECK(outputs[2 * k + 1] == inputs[k]);
+    }
+
+    // an input stride of 0 holds the inputs constant
+    const double constant = -1;
+    series.inputValues = &constant;
+    series.inputStride = 0;
+    REQUIRE(fmu4cppDoSteps(c, time, 0.1, 2, &series, &nCompleted, &time) == fmiOK);
+    CHECK(outputs[1] == -1);
+    CHECK(outputs[3] == -1);
+
+    // the series ends at the stop time
+    REQUIRE(fmu4cppDoSteps(c, time, 0.1, nSteps, nullptr, &nCompleted, &time) == fmiDiscard);
+    CHECK(nCompleted == 3);
+    CHECK(time == Catch::Approx(1));
+
+    fmi2FreeInstance(c);
+}
+
+TEST_CASE("test_do_steps_invalid") {
+
+    Model model({});
+    const auto guid = model.guid();
+
+    const unsigned int realIn = model.find_real_variable("realIn")->value_reference();
+    const unsigned int integerIn = model.find_int_variable("integerIn")->value_reference();
+
+    fmi2CallbackFunctions callbackFunctions;
+    callbackFunctions.logger = &fmilogger;
+
+    const auto c = fmi2Instantiate("identity", fmi2CoSimulation, guid.c_str(), "", &callbackFunctions, false, false);
+    REQUIRE(c);
+    REQUIRE(fmi2SetupExperiment(c, false, 0, 0, false, 0) == fmi2OK);
+    REQUIRE(fmi2EnterInitializationMode(c) == fmi2OK);
+    REQUIRE(fmi2ExitInitializationMode(c) == fmi2OK);
+
+    const double values[]{1, 2};
+    fmu4cppStepSeries series{};
+    series.inputVr = &integerIn;
+    series.nInputs = 1;
+    series.inputValues = values;
+
+    // only Reals, and nothing is stepped then
+    size_t nCompleted;
+    double time;
+    REQUIRE(fmu4cppDoSteps(c, 0, 0.1, 2, &series, &nCompleted, &time) == fmiError);
+    CHECK(nCompleted == 0);
+    CHECK(time == 0);
+
+    // outputs would overlap
+    const unsigned int both[]{realIn, realIn};
+    double outputs[3];
+    series = {};
+    series.outputVr = both;
+    series.nOutputs = 2;
+    series.outputValues = outputs;
+    series.outputStride = 1;
+    REQUIRE(fmu4cppDoSteps(c, 0, 0.1, 2, &series, &nCompleted, &time) == fmiError);
+
+    fmi2FreeInstance(c);
+}
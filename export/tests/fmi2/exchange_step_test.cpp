@@ -0,0 +1,112 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <iostream>
+#include <string>
+
+#include <fmu4cpp/fmu_base.hpp>
+#include <fmu4cpp/vendor_extensions.h>
+
+#include "Identity.hpp"
+#include "fmi2/fmi2Functions.h"
+
+
+std::string fmu4cpp::model_identifier() {
+    return "identity";
+}
+
+void fmilogger(fmi2Component, fmi2String instanceName, fmi2Status status, fmi2String /*category*/, fmi2String message, ...) {
+    std::cerr << instanceName << ": " << message << std::endl;
+}
+
+TEST_CASE("test_exchange_step") {
+
+    Model model({});
+    const auto guid = model.guid();
+
+    const unsigned int integerIn = model.find_int_variable("integerIn")->value_reference();
+    const unsigned int integerOut = model.find_int_variable("integerOut")->value_reference();
+    const unsigned int realIn = model.find_real_variable("realIn")->value_reference();
+    const unsigned int realOut = model.find_real_variable("realOut")->value_reference();
+    const unsigned int booleanIn = model.find_bool_variable("booleanIn")->value_reference();
+    const unsigned int booleanOut = model.find_bool_variable("booleanOut")->value_reference();
+    const unsigned int stringIn = model.find_string_variable("stringIn")->value_reference();
+    const unsigned int stringOut = model.find_string_variable("stringOut")->value_reference();
+
+    fmi2CallbackFunctions callbackFunctions;
+    callbackFunctions.logger = &fmilogger;
+
+    const auto c = fmi2Instantiate("identity", fmi2CoSimulation, guid.c_str(), "", &callbackFunctions, false, true);
+    REQUIRE(c);
+
+    REQUIRE(fmi2SetupExperiment(c, false, 0, 0, false, 0) == fmi2OK);
+    REQUIRE(fmi2EnterInitializationMode(c) == fmi2OK);
+    REQUIRE(fmi2ExitInitializationMode(c) == fmi2OK);
+
+    double realValue = 2.5;
+    int integerValue = 7;
+    bool booleanValue = true;
+    const char *stringValue = "exchanged";
+
+    fmu4cppStepValues inputs{};
+    inputs.realVr = &realIn;
+    inputs.nReal = 1;
+    inputs.realValues = &realValue;
+    inputs.integerVr = &integerIn;
+    inputs.nInteger = 1;
+    inputs.integerValues = &integerValue;
+    inputs.booleanVr = &booleanIn;
+    inputs.nBoolean = 1;
+    inputs.booleanValues = &booleanValue;
+    inputs.stringVr = &stringIn;
+    inputs.nString = 1;
+    inputs.stringValues = &stringValue;
+
+    const unsigned int reals[]{0, realOut};// time is vr 0
+    double realOutputs[2]{};
+    int integerOutput{};
+    bool booleanOutput{};
+    const char *stringOutput{};
+
+    fmu4cppStepValues outputs{};
+    outputs.realVr = reals;
+    outputs.nReal = 2;
+    outputs.realValues = realOutputs;
+    outputs.integerVr = &integerOut;
+    outputs.nInteger = 1;
+    outputs.integerValues = &integerOutput;
+    outputs.booleanVr = &booleanOut;
+    outputs.nBoolean = 1;
+    outputs.booleanValues = &booleanOutput;
+    outputs.stringVr = &stringOut;
+    outputs.nString = 1;
+    outputs.stringValues = &stringOutput;
+
+    double lastSuccessfulTime{};
+    REQUIRE(fmu4cppExchangeStep(c, &inputs, 0, 0.1, &outputs, &lastSuccessfulTime, nullptr, nullptr) == fmiOK);
+    REQUIRE(lastSuccessfulTime == 0.1);
+    REQUIRE(realOutputs[0] == 0.1);
+    REQUIRE(realOutputs[1] == 2.5);
+    REQUIRE(integerOutput == 7);
+    REQUIRE(booleanOutput);
+    REQUIRE(std::string(stringOutput) == "exchanged");
+
+    // either side may be left out
+    realValue = 4;
+    inputs.nInteger = inputs.nBoolean = inputs.nString = 0;
+    REQUIRE(fmu4cppExchangeStep(c, &inputs, 0.1, 0.1, nullptr, nullptr, nullptr, nullptr) == fmiOK);
+    REQUIRE(fmu4cppExchangeStep(c, nullptr, 0.2, 0.1, &outputs, &lastSuccessfulTime, nullptr, nullptr) == fmiOK);
+    REQUIRE(realOutputs[1] == 4);
+    REQUIRE(lastSuccessfulTime == Catch::Approx(0.3));
+
+    // outputs cannot be set, and nothing is stepped then
+    inputs.realVr = &realOut;
+    REQUIRE(fmu4cppExchangeStep(c, &inputs, 0.3, 0.1, &outputs, nullptr, nullptr, nullptr) == fmiError);
+    double time;
+    const fmi2ValueReference timeVr = 0;
+    REQUIRE(fmi2GetReal(c, &timeVr, 1, &time) == fmi2OK);
+    REQUIRE(time == Catch::Approx(0.3));
+
+    REQUIRE(fmi2Terminate(c) == fmi2OK);
+    fmi2FreeInstance(c);
+}
@@ -0,0 +1,178 @@
+#include "fmi2/fmi2Functions.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstdarg>
+#include <iostream>
+
+#include <fmu4cpp/fmu_base.hpp>
+#include <fmu4cpp/vendor_extensions.h>
+
+// Exponential decay of two independent states, towards the input.
+class Model : public fmu4cpp::fmu_base {
+
+public:
+    FMU4CPP_CTOR(Model) {
+
+        register_real("target", &target_)
+                .setCausality(fmu4cpp::causality_t::INPUT);
+        register_continuous_states("x", x_, dx_, 2);
+    }
+
+    void update_derivatives() override {
+        for (int i = 0; i < 2; i++) {
+            dx_[i] = (i + 1) * (target_ - x_[i]);
+        }
+    }
+
+    bool do_step(double dt) override {
+        update_derivatives();
+        for (int i = 0; i < 2; i++) {
+            x_[i] += dx_[i] * dt;
+        }
+        return true;
+    }
+
+private:
+    double target_{0};
+    double x_[2]{1, 1};
+    double dx_[2]{};
+};
+
+fmu4cpp::model_info fmu4cpp::get_model_info() {
+    model_info info;
+    info.modelName = "Decay";
+    return info;
+}
+
+std::string fmu4cpp::model_identifier() {
+    return "model_exchange";
+}
+
+FMU4CPP_INSTANTIATE(Model);
+
+
+void fmilogger(fmi2Component, fmi2String instanceName, fmi2Status status, fmi2String /*category*/, fmi2String message, ...) {
+    va_list args;
+    va_start(args, message);
+    char msgstr[1024];
+    sprintf(msgstr, "%i: [%s] %s\n", status, instanceName, message);
+    printf(msgstr, args);
+    va_end(args);
+}
+
+TEST_CASE("test_model_exchange") {
+
+    Model model({});
+    const auto guid = model.guid();
+
+    // time is vr 0, followed by target, x[0..1] and der(x[0..1]), index is vr + 1
+    const fmi2ValueReference target = 1;
+
+    const auto description = model.make_description();
+    std::cout << description << std::endl;
+    REQUIRE(description.find("<ModelExchange") != std::string::npos);
+    REQUIRE(description.find("name=\"der(x[0])\" valueReference=\"4\"") != std::string::npos);
+    REQUIRE(description.find("derivative=\"3\"") != std::string::npos);
+    REQUIRE(description.find("<Derivatives>") != std::string::npos);
+
+    fmi2CallbackFunctions callbackFunctions;
+    callbackFunctions.logger = &fmilogger;
+
+    auto c = fmi2Instantiate("model_exchange", fmi2ModelExchange, guid.c_str(), "", &callbackFunctions, false, true);
+    REQUIRE(c);
+
+    double x[2], dx[2];
+    // neither the states nor the derivatives are available before initialisation
+    REQUIRE(fmi2GetContinuousStates(c, x, 2) == fmi2Error);
+    REQUIRE(fmi2GetDerivatives(c, dx, 2) == fmi2Error);
+
+    REQUIRE(fmi2SetupExperiment(c, false, 0, 0, false, 0) == fmi2OK);
+    REQUIRE(fmi2EnterInitializationMode(c) == fmi2OK);
+    REQUIRE(fmi2EnterContinuousTimeMode(c) == fmi2Error);
+    REQUIRE(fmi2ExitInitializationMode(c) == fmi2OK);
+
+    // initialisation ends in event mode
+    fmi2Boolean enterEventMode, terminateSimulation;
+    REQUIRE(fmi2CompletedIntegratorStep(c, true, &enterEventMode, &terminateSimulation) == fmi2Error);
+    REQUIRE(fmi2SetContinuousStates(c, x, 2) == fmi2Error);
+    REQUIRE(fmi2EnterEventMode(c) == fmi2Error);
+    REQUIRE(fmi2SetTime(c, 0) == fmi2OK);
+
+    fmi2EventInfo eventInfo;
+    REQUIRE(fmi2NewDiscreteStates(c, &eventInfo) == fmi2OK);
+    REQUIRE_FALSE(eventInfo.newDiscreteStatesNeeded);
+    REQUIRE_FALSE(eventInfo.nextEventTimeDefined);
+    REQUIRE(fmi2EnterContinuousTimeMode(c) == fmi2OK);
+    REQUIRE(fmi2NewDiscreteStates(c, &eventInfo) == fmi2Error);
+
+    REQUIRE(fmi2GetContinuousStates(c, x, 2) == fmi2OK);
+    REQUIRE(fmi2GetDerivatives(c, dx, 2) == fmi2OK);
+    REQUIRE(dx[0] == -1);
+    REQUIRE(dx[1] == -2);
+
+    // the derivatives follow the states and the inputs
+    const double targetValue = 2;
+    REQUIRE(fmi2SetReal(c, &target, 1, &targetValue) == fmi2OK);
+    REQUIRE(fmi2GetDerivatives(c, dx, 2) == fmi2OK);
+    REQUIRE(dx[0] == 1);
+    REQUIRE(dx[1] == 2);
+
+    const double dt = 1e-3;
+    double t = 0;
+    for (int i = 0; i < 5000; i++) {
+        REQUIRE(fmi2GetDerivatives(c, dx, 2) == fmi2OK);
+        t += dt;
+        for (int j = 0; j < 2; j++) {
+            x[j] += dx[j] * dt;
+        }
+        REQUIRE(fmi2SetTime(c, t) == fmi2OK);
+        REQUIRE(fmi2SetContinuousStates(c, x, 2) == fmi2OK);
+
+        REQUIRE(fmi2CompletedIntegratorStep(c, true, &enterEventMode, &terminateSimulation) == fmi2OK);
+        REQUIRE_FALSE(enterEventMode);
+    }
+    CHECK(x[0] == Catch::Approx(2 - std::exp(-5.0)).epsilon(1e-2));
+
+    // and back through event mode
+    REQUIRE(fmi2EnterEventMode(c) == fmi2OK);
+    REQUIRE(fmi2NewDiscreteStates(c, &eventInfo) == fmi2OK);
+    REQUIRE(fmi2EnterContinuousTimeMode(c) == fmi2OK);
+
+    // the states are also plain variables
+    const fmi2ValueReference states[]{2, 3};
+    double values[2];
+    REQUIRE(fmi2GetReal(c, states, 2, values) == fmi2OK);
+    REQUIRE(values[0] == x[0]);
+    REQUIRE(values[1] == x[1]);
+
+    REQUIRE(fmi2GetDerivatives(c, dx, 1) == fmi2Error);
+    REQUIRE(fmi2DoStep(c, t, 0.1, true) == fmi2Error);
+    // as are the stepping extensions
+    REQUIRE(fmu4cppExchangeStep(c, nullptr, t, 0.1, nullptr, nullptr, nullptr, nullptr) == fmiError);
+    size_t nCompleted;
+    REQUIRE(fmu4cppDoSteps(c, t, 0.1, 2, nullptr, &nCompleted, nullptr) == fmiError);
+    REQUIRE(nCompleted == 0);
+
+    REQUIRE(fmi2Terminate(c) == fmi2OK);
+    fmi2FreeInstance(c);
+}
+
+TEST_CASE("test_model_exchange_not_for_co_simulation") {
+
+    Model model({});
+    const auto guid = model.guid();
+
+    fmi2CallbackFunctions callbackFunctions;
+    callbackFunctions.logger = &fmilogger;
+
+    auto c = fmi2Instantiate("model_exchange", fmi2CoSimulation, guid.c_str(), "", &callbackFunctions, false, false);
+    REQUIRE(c);
+
+    double x[2];
+    REQUIRE(fmi2GetContinuousStates(c, x, 2) == fmi2Error);
+
+    fmi2FreeInstance(c);
+}
@@ -0,0 +1,132 @@
+#include "fmi2/fmi2Functions.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdarg>
+#include <iostream>
+#include <numeric>
+#include <unordered_set>
+
+#include <fmu4cpp/fmu_base.hpp>
+
+constexpr size_t numSignals = 8;
+
+class Model : public fmu4cpp::fmu_base {
+
+public:
+    FMU4CPP_CTOR(Model), inputs_(numSignals), channels_(2 * numSignals) {
+
+        register_real_range("in", inputs_.data(), inputs_.size())
+                .setCausality(fmu4cpp::causality_t::INPUT);
+        register_real("gain", &gain_)
+                .setCausality(fmu4cpp::causality_t::PARAMETER)
+                .setVariability(fmu4cpp::variability_t::TUNABLE);
+        // every other channel, the ones in between hold the previous value
+        register_real_range("out", channels_.data(), numSignals, 2)
+                .setCausality(fmu4cpp::causality_t::OUTPUT)
+                .setUnit("V");
+    }
+
+    bool do_step(double dt) override {
+        for (size_t i = 0; i < numSignals; i++) {
+            channels_[2 * i + 1] = channels_[2 * i];
+            channels_[2 * i] = gain_ * inputs_[i];
+        }
+        return true;
+    }
+
+private:
+    std::vector<double> inputs_;
+    std::vector<double> channels_;
+    double gain_{2};
+};
+
+fmu4cpp::model_info fmu4cpp::get_model_info() {
+    model_info info;
+    info.modelName = "Range";
+    info.description = "A model with strided Real ranges";
+    return info;
+}
+
+std::string fmu4cpp::model_identifier() {
+    return "range";
+}
+
+FMU4CPP_INSTANTIATE(Model);
+
+
+void fmilogger(fmi2Component, fmi2String instanceName, fmi2Status status, fmi2String /*category*/, fmi2String message, ...) {
+    va_list args;
+    va_start(args, message);
+    char msgstr[1024];
+    sprintf(msgstr, "%i: [%s] %s\n", status, instanceName, message);
+    printf(msgstr, args);
+    va_end(args);
+}
+
+TEST_CASE("test_range") {
+
+    Model model({});
+    const auto guid = model.guid();
+
+    auto vrs = model.get_value_refs();
+    REQUIRE(vrs.size() == 2 * numSignals + 1 + 1);// ranges, gain and time
+    std::unordered_set<unsigned int> unique_vrs(vrs.begin(), vrs.end());
+    REQUIRE(unique_vrs.size() == vrs.size());
+
+    // time is vr 0, followed by in[0..7], gain and out[0..7]
+    const fmi2ValueReference gain = 1 + numSignals;
+    std::vector<fmi2ValueReference> inputs(numSignals);
+    std::iota(inputs.begin(), inputs.end(), 1);
+    std::vector<fmi2ValueReference> outputs(numSignals);
+    std::iota(outputs.begin(), outputs.end(), gain + 1);
+
+    const auto description = model.make_description();
+    std::cout << description << std::endl;
+    REQUIRE(description.find("name=\"in[0]\" valueReference=\"1\" causality=\"input\"") != std::string::npos);
+    REQUIRE(description.find("name=\"out[7]\" valueReference=\"" + std::to_string(outputs.back()) + "\" causality=\"output\"") != std::string::npos);
+    REQUIRE(description.find("unit=\"V\"") != std::string::npos);
+    REQUIRE(description.find("<Unknown index=\"" + std::to_string(outputs.back() + 1) + "\"/>") != std::string::npos);
+
+    // elements are not variables of their own
+    REQUIRE_FALSE(model.find_real_variable("in[0]"));
+
+    fmi2CallbackFunctions callbackFunctions;
+    callbackFunctions.logger = &fmilogger;
+
+    auto c = fmi2Instantiate("range", fmi2CoSimulation, guid.c_str(), "", &callbackFunctions, false, true);
+    REQUIRE(c);
+
+    REQUIRE(fmi2SetupExperiment(c, false, 0, 0, false, 0) == fmi2OK);
+    REQUIRE(fmi2EnterInitializationMode(c) == fmi2OK);
+    REQUIRE(fmi2ExitInitializationMode(c) == fmi2OK);
+
+    std::vector<double> values(numSignals);
+    std::iota(values.begin(), values.end(), 1.0);
+    REQUIRE(fmi2SetReal(c, inputs.data(), inputs.size(), values.data()) == fmi2OK);
+    REQUIRE(fmi2DoStep(c, 0, 0.1, true) == fmi2OK);
+
+    REQUIRE(fmi2GetReal(c, outputs.data(), outputs.size(), values.data()) == fmi2OK);
+    REQUIRE(values == std::vector<double>{2, 4, 6, 8, 10, 12, 14, 16});
+
+    // ranges and other variables mixed, in any order
+    const std::vector<fmi2ValueReference> mixed{outputs[3], gain, inputs[7], inputs[2], 0};
+    std::vector<double> mixedValues(mixed.size());
+    REQUIRE(fmi2GetReal(c, mixed.data(), mixed.size(), mixedValues.data()) == fmi2OK);
+    REQUIRE(mixedValues == std::vector<double>{8, 2, 8, 3, 0.1});
+
+    const std::vector<fmi2ValueReference> toSet{inputs[0], gain};
+    const std::vector<double> newValues{-1, 3};
+    REQUIRE(fmi2SetReal(c, toSet.data(), toSet.size(), newValues.data()) == fmi2OK);
+    REQUIRE(fmi2DoStep(c, 0.1, 0.1, true) == fmi2OK);
+    REQUIRE(fmi2GetReal(c, outputs.data(), 2, values.data()) == fmi2OK);
+    REQUIRE(values[0] == -3);
+    REQUIRE(values[1] == 6);
+
+    // outputs cannot be set
+    REQUIRE(fmi2SetReal(c, &outputs[1], 1, newValues.data()) == fmi2Error);
+
+    REQUIRE(fmi2Terminate(c) == fmi2OK);
+
+    fmi2FreeInstance(c);
+}
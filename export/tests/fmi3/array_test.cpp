@@ -16,15 +16,9 @@ class Model : public fmu4cpp::fmu_base {
 public:
     FMU4CPP_CTOR(Model), reals_(4) {
 
-        for (int i = 0; i < reals_.size(); i++) {
-            // clang-format off
-            register_real("real[" + std::to_string(i) + "]",
-                [this, i] { return reals_[i]; },
-                [this, i](double val) { reals_[i] = val; })
-            .setCausality(fmu4cpp::causality_t::PARAMETER)
-            .setVariability(fmu4cpp::variability_t::TUNABLE);
-            // clang-format on
-        }
+        register_real_array("real", reals_.data(), {reals_.size()})
+                .setCausality(fmu4cpp::causality_t::PARAMETER)
+                .setVariability(fmu4cpp::variability_t::TUNABLE);
 
         Model::reset();
     }
@@ -72,6 +66,12 @@ TEST_CASE("test_array") {
     // Check that all are unique
     REQUIRE(unique_vrs.size() == vrs.size());
 
+    const auto description = model.make_description();
+    REQUIRE(description.find("name=\"real\"") != std::string::npos);
+    REQUIRE(description.find("name=\"real[1]\"") == std::string::npos);
+    REQUIRE(description.find("start=\"1 2 3 4\"") != std::string::npos);
+    REQUIRE(description.find("<Dimension start=\"4\"/>") != std::string::npos);
+
     auto c = fmi3InstantiateCoSimulation("array", guid.c_str(), "", false, true, false, false, nullptr, 0, nullptr, fmilogger, nullptr);
     REQUIRE(c);
 
@@ -79,27 +79,25 @@ TEST_CASE("test_array") {
     REQUIRE(fmi3ExitInitializationMode(c) == fmi3OK);
 
 
+    // the whole array is a single variable, moved with one call
+    const fmi3ValueReference ref = 1;
     std::vector<double> values(4);
-    for (int i = 1; i <= 4; i++) {// account for time
-        fmi3ValueReference ref = i;
-        fmi3GetFloat64(c, &ref, 1, &values[i - 1], 1);
-    }
+    REQUIRE(fmi3GetFloat64(c, &ref, 1, values.data(), values.size()) == fmi3OK);
     REQUIRE(values == std::vector<double>{1, 2, 3, 4});
 
-    for (int i = 1; i <= 4; i++) {
-        fmi3ValueReference ref = i;
-        fmi3Float64 val = 9;
-        fmi3SetFloat64(c, &ref, 1, &val, 1);
-    }
-
-    for (int i = 1; i <= 4; i++) {
-        fmi3ValueReference ref = i;
-        fmi3GetFloat64(c, &ref, 1, &values[i - 1], 1);
-    }
-    REQUIRE(values == std::vector<double>{9, 9, 9, 9});
+    const std::vector<double> newValues{9, 8, 7, 6};
+    REQUIRE(fmi3SetFloat64(c, &ref, 1, newValues.data(), newValues.size()) == fmi3OK);
 
+    // mixed with a scalar
+    const std::vector<fmi3ValueReference> refs{0, 1};
+    std::vector<double> withTime(5);
+    REQUIRE(fmi3GetFloat64(c, refs.data(), refs.size(), withTime.data(), withTime.size()) == fmi3OK);
+    REQUIRE(withTime == std::vector<double>{0, 9, 8, 7, 6});
 
     REQUIRE(fmi3Terminate(c) == fmi3OK);
 
+    // too few values for the array
+    REQUIRE(fmi3GetFloat64(c, &ref, 1, values.data(), 2) == fmi3Error);
+
     fmi3FreeInstance(c);
 }
@@ -0,0 +1,194 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <iostream>
+#include <vector>
+
+#include <fmu4cpp/fmu_base.hpp>
+
+#include "fmi3/fmi3Functions.h"
+#include "fmu4cpp/vendor_extensions.h"
+
+using namespace fmu4cpp;
+
+// Integrates dx/dt = 1 in ten internal steps per communication step,
+// and asks to return early when x crosses the threshold.
+class Model : public fmu_base {
+
+public:
+    FMU4CPP_CTOR(Model) {
+
+        register_real("x", &x_).setCausality(causality_t::OUTPUT);
+        register_real("threshold", &threshold_)
+                .setCausality(causality_t::PARAMETER)
+                .setVariability(variability_t::TUNABLE);
+    }
+
+    bool do_step(double dt) override {
+        constexpr int n = 10;
+        const double start = currentTime();
+        for (int i = 1; i <= n; i++) {
+            const double t = start + i * dt / n;
+            const bool crossing = x_ < threshold_ && x_ + dt / n >= threshold_;
+            x_ += dt / n;
+            if (i == n) break;
+            if (crossing && request_early_return(t)) return true;
+            if (publish_intermediate(t)) return true;
+        }
+        return true;
+    }
+
+private:
+    double x_{0};
+    double threshold_{0.55};
+};
+
+model_info fmu4cpp::get_model_info() {
+    return {};
+}
+
+std::string fmu4cpp::model_identifier() {
+    return "early_return";
+}
+
+FMU4CPP_INSTANTIATE(Model);
+
+void fmilogger(fmi3InstanceEnvironment, fmi3Status, fmi3String, fmi3String message) {
+    std::cerr << message << std::endl;
+}
+
+struct Importer {
+    fmi3Instance instance{nullptr};
+    double earlyReturnAt{-1};// requested on the first update past this time, if not negative
+    std::vector<double> times;
+    std::vector<double> values;
+    std::vector<bool> canReturnEarly;
+};
+
+void intermediateUpdate(fmi3InstanceEnvironment env, fmi3Float64 time,
+                        fmi3Boolean /*setRequested*/, fmi3Boolean getAllowed, fmi3Boolean /*stepFinished*/,
+                        fmi3Boolean canReturnEarly, fmi3Boolean *earlyReturnRequested, fmi3Float64 *earlyReturnTime) {
+    auto &importer = *static_cast<Importer *>(env);
+    importer.times.push_back(time);
+    importer.canReturnEarly.push_back(canReturnEarly);
+    if (getAllowed) {
+        const fmi3ValueReference x = 1;
+        double value;
+        fmi3GetFloat64(importer.instance, &x, 1, &value, 1);
+        importer.values.push_back(value);
+    }
+    if (importer.earlyReturnAt >= 0 && time > importer.earlyReturnAt) {
+        *earlyReturnRequested = true;
+        *earlyReturnTime = importer.earlyReturnAt;
+    }
+}
+
+fmi3Instance instantiate(Importer &importer, bool earlyReturnAllowed) {
+    Model model({});
+    const auto guid = model.guid();
+
+    const fmi3ValueReference required[] = {1};
+    importer.instance = fmi3InstantiateCoSimulation("early_return", guid.c_str(), "", false, true, false, earlyReturnAllowed,
+                                                    required, 1, &importer, fmilogger, intermediateUpdate);
+    REQUIRE(importer.instance);
+    REQUIRE(fmi3EnterInitializationMode(importer.instance, false, 0, 0, false, 0) == fmi3OK);
+    REQUIRE(fmi3ExitInitializationMode(importer.instance) == fmi3OK);
+    return importer.instance;
+}
+
+TEST_CASE("intermediate updates without early return") {
+
+    Importer importer;
+    const auto c = instantiate(importer, false);
+
+    bool eventHandlingNeeded, terminateSimulation, earlyReturn;
+    double lastSuccessfulTime;
+    REQUIRE(fmi3DoStep(c, 0, 1, true, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime) == fmi3OK);
+    CHECK_FALSE(earlyReturn);
+    CHECK(lastSuccessfulTime == 1);
+
+    // the end of the step is not an intermediate update
+    REQUIRE(importer.times.size() == 9);
+    for (size_t i = 0; i < importer.times.size(); i++) {
+        CHECK(importer.times[i] == Catch::Approx(0.1 * static_cast<double>(i + 1)));
+        CHECK(importer.values[i] == Catch::Approx(importer.times[i]));
+        CHECK_FALSE(importer.canReturnEarly[i]);
+    }
+
+    fmi3FreeInstance(c);
+}
+
+TEST_CASE("early return requested by the model") {
+
+    Importer importer;
+    const auto c = instantiate(importer, true);
+
+    bool eventHandlingNeeded, terminateSimulation, earlyReturn;
+    double lastSuccessfulTime;
+    REQUIRE(fmi3DoStep(c, 0, 1, true, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime) == fmi3OK);
+    CHECK(earlyReturn);
+    CHECK(lastSuccessfulTime == Catch::Approx(0.6));
+    CHECK(importer.times.size() == 5);
+    CHECK(importer.canReturnEarly.front());
+
+    // the next step starts where the last one ended
+    REQUIRE(fmi3DoStep(c, lastSuccessfulTime, 1 - lastSuccessfulTime, true, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime) == fmi3OK);
+    CHECK_FALSE(earlyReturn);
+    CHECK(lastSuccessfulTime == Catch::Approx(1));
+
+    const fmi3ValueReference x = 1;
+    double value;
+    REQUIRE(fmi3GetFloat64(c, &x, 1, &value, 1) == fmi3OK);
+    CHECK(value == Catch::Approx(1));
+
+    fmi3FreeInstance(c);
+}
+
+TEST_CASE("early return requested by the importer") {
+
+    Importer importer;
+    importer.earlyReturnAt = 0.25;
+    const auto c = instantiate(importer, true);
+
+    // raise the threshold, so that only the importer asks for an early return
+    const fmi3ValueReference threshold = 2;
+    const double never = 10;
+    REQUIRE(fmi3SetFloat64(c, &threshold, 1, &never, 1) == fmi3OK);
+
+    bool eventHandlingNeeded, terminateSimulation, earlyReturn;
+    double lastSuccessfulTime;
+    REQUIRE(fmi3DoStep(c, 0, 1, true, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime) == fmi3OK);
+    CHECK(earlyReturn);
+    // the first intermediate point at or after the requested time
+    CHECK(lastSuccessfulTime == Catch::Approx(0.3));
+
+    fmi3FreeInstance(c);
+}
+
+TEST_CASE("early return through fmu4cppExchangeStep") {
+
+    Importer importer;
+    const auto c = instantiate(importer, true);
+
+    const fmi3ValueReference x = 1;
+    double value;
+    fmu4cppStepValues outputs{};
+    outputs.realVr = &x;
+    outputs.nReal = 1;
+    outputs.realValues = &value;
+
+    double lastSuccessfulTime;
+    bool earlyReturn, eventHandlingNeeded;
+    REQUIRE(fmu4cppExchangeStep(c, nullptr, 0, 1, &outputs, &lastSuccessfulTime, &earlyReturn, &eventHandlingNeeded) == fmiOK);
+    CHECK(earlyReturn);
+    CHECK_FALSE(eventHandlingNeeded);
+    CHECK(lastSuccessfulTime == Catch::Approx(0.6));
+    CHECK(value == Catch::Approx(0.6));
+
+    REQUIRE(fmu4cppExchangeStep(c, nullptr, lastSuccessfulTime, 1 - lastSuccessfulTime, &outputs, &lastSuccessfulTime, &earlyReturn, &eventHandlingNeeded) == fmiOK);
+    CHECK_FALSE(earlyReturn);
+    CHECK(lastSuccessfulTime == Catch::Approx(1));
+    CHECK(value == Catch::Approx(1));
+
+    fmi3FreeInstance(c);
+}
@@ -0,0 +1,168 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <iostream>
+
+#include <fmu4cpp/fmu_base.hpp>
+
+#include "fmi3/fmi3Functions.h"
+
+using namespace fmu4cpp;
+
+// A square wave that toggles at time events, and its integral.
+class Model : public fmu_base {
+
+public:
+    FMU4CPP_CTOR(Model) {
+
+        register_boolean("level", &level_).setCausality(causality_t::OUTPUT);
+        register_real("integral", &integral_).setCausality(causality_t::OUTPUT);
+        register_integer("toggles", &toggles_).setCausality(causality_t::OUTPUT);
+    }
+
+    void enter_initialisation_mode() override {
+        schedule_time_event(currentTime() + period);
+    }
+
+    bool do_step(double dt) override {
+        if (level_) integral_ += dt;
+        return true;
+    }
+
+    bool do_discrete_update(bool timeEvent) override {
+        if (timeEvent) {
+            level_ = !level_;
+            ++toggles_;
+            schedule_time_event(currentTime() + period);
+        }
+        return false;
+    }
+
+private:
+    static constexpr double period = 0.3;
+
+    bool level_{false};
+    double integral_{0};
+    int toggles_{0};
+};
+
+model_info fmu4cpp::get_model_info() {
+    model_info info;
+    info.hasEventMode = true;
+    return info;
+}
+
+std::string fmu4cpp::model_identifier() {
+    return "event_mode";
+}
+
+FMU4CPP_INSTANTIATE(Model);
+
+void fmilogger(fmi3InstanceEnvironment, fmi3Status, fmi3String, fmi3String message) {
+    std::cerr << message << std::endl;
+}
+
+// time is vr 0, then in order of registration
+const fmi3ValueReference level = 1, integral = 2, toggles = 3;
+
+fmi3Instance instantiate(bool eventModeUsed) {
+    Model model({});
+    const auto guid = model.guid();
+    REQUIRE(model.make_description().find("hasEventMode=\"true\"") != std::string::npos);
+
+    const auto c = fmi3InstantiateCoSimulation("event_mode", guid.c_str(), "", false, true, eventModeUsed, true, nullptr, 0, nullptr, fmilogger, nullptr);
+    REQUIRE(c);
+    REQUIRE(fmi3EnterInitializationMode(c, false, 0, 0, false, 0) == fmi3OK);
+    REQUIRE(fmi3ExitInitializationMode(c) == fmi3OK);
+    return c;
+}
+
+TEST_CASE("initialisation is followed by event mode") {
+
+    const auto c = instantiate(true);
+
+    bool needsUpdate, terminate, nominalsChanged, valuesChanged, nextEventTimeDefined;
+    double nextEventTime;
+    REQUIRE(fmi3UpdateDiscreteStates(c, &needsUpdate, &terminate, &nominalsChanged, &valuesChanged, &nextEventTimeDefined, &nextEventTime) == fmi3OK);
+    CHECK_FALSE(needsUpdate);
+    REQUIRE(nextEventTimeDefined);
+    CHECK(nextEventTime == Catch::Approx(0.3));
+
+    // no stepping before fmi3EnterStepMode
+    bool eventHandlingNeeded, terminateSimulation, earlyReturn;
+    double lastSuccessfulTime;
+    CHECK(fmi3DoStep(c, 0, 1, true, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime) == fmi3Error);
+    fmi3FreeInstance(c);
+}
+
+TEST_CASE("event mode cycle") {
+
+    const auto c = instantiate(true);
+
+    bool needsUpdate, terminate, nominalsChanged, valuesChanged, nextEventTimeDefined;
+    double nextEventTime;
+    REQUIRE(fmi3UpdateDiscreteStates(c, &needsUpdate, &terminate, &nominalsChanged, &valuesChanged, &nextEventTimeDefined, &nextEventTime) == fmi3OK);
+    REQUIRE(fmi3EnterStepMode(c) == fmi3OK);
+
+    // the step ends at the time event, well before its end
+    bool eventHandlingNeeded, terminateSimulation, earlyReturn;
+    double lastSuccessfulTime;
+    REQUIRE(fmi3DoStep(c, 0, 1, true, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime) == fmi3OK);
+    CHECK(eventHandlingNeeded);
+    CHECK(earlyReturn);
+    CHECK(lastSuccessfulTime == Catch::Approx(0.3));
+
+    bool levelValue;
+    REQUIRE(fmi3GetBoolean(c, &level, 1, &levelValue, 1) == fmi3OK);
+    CHECK_FALSE(levelValue);
+
+    REQUIRE(fmi3EnterEventMode(c) == fmi3OK);
+    REQUIRE(fmi3UpdateDiscreteStates(c, &needsUpdate, &terminate, &nominalsChanged, &valuesChanged, &nextEventTimeDefined, &nextEventTime) == fmi3OK);
+    CHECK_FALSE(needsUpdate);
+    REQUIRE(nextEventTimeDefined);
+    CHECK(nextEventTime == Catch::Approx(0.6));
+    REQUIRE(fmi3GetBoolean(c, &level, 1, &levelValue, 1) == fmi3OK);
+    CHECK(levelValue);
+    REQUIRE(fmi3EnterStepMode(c) == fmi3OK);
+
+    // a step that ends exactly at the next event
+    REQUIRE(fmi3DoStep(c, lastSuccessfulTime, nextEventTime - lastSuccessfulTime, true, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime) == fmi3OK);
+    CHECK(eventHandlingNeeded);
+    CHECK_FALSE(earlyReturn);
+    CHECK(lastSuccessfulTime == Catch::Approx(0.6));
+
+    double integralValue;
+    REQUIRE(fmi3GetFloat64(c, &integral, 1, &integralValue, 1) == fmi3OK);
+    CHECK(integralValue == Catch::Approx(0.3));
+
+    // only entered from step mode
+    REQUIRE(fmi3EnterEventMode(c) == fmi3OK);
+    CHECK(fmi3EnterEventMode(c) == fmi3Error);
+
+    fmi3FreeInstance(c);
+}
+
+TEST_CASE("time events without event mode") {
+
+    const auto c = instantiate(false);
+
+    // the events at 0.3, 0.6 and 0.9 are handled within the step
+    bool eventHandlingNeeded, terminateSimulation, earlyReturn;
+    double lastSuccessfulTime;
+    REQUIRE(fmi3DoStep(c, 0, 1, true, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime) == fmi3OK);
+    CHECK_FALSE(eventHandlingNeeded);
+    CHECK_FALSE(earlyReturn);
+    CHECK(lastSuccessfulTime == 1);
+
+    int togglesValue;
+    REQUIRE(fmi3GetInt32(c, &toggles, 1, &togglesValue, 1) == fmi3OK);
+    CHECK(togglesValue == 3);
+
+    double integralValue;
+    REQUIRE(fmi3GetFloat64(c, &integral, 1, &integralValue, 1) == fmi3OK);
+    CHECK(integralValue == Catch::Approx(0.3 + 0.1));
+
+    CHECK(fmi3EnterEventMode(c) == fmi3Error);
+
+    fmi3FreeInstance(c);
+}
@@ -0,0 +1,276 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <iostream>
+
+#include <fmu4cpp/fmu_base.hpp>
+
+#include "fmi3/fmi3Functions.h"
+
+using namespace fmu4cpp;
+
+// A harmonic oscillator, x[0] is the position and x[1] the velocity.
+class Model : public fmu_base {
+
+public:
+    FMU4CPP_CTOR(Model) {
+
+        register_real("k", &k_)
+                .setCausality(causality_t::PARAMETER)
+                .setVariability(variability_t::TUNABLE);
+        register_real("energy", &energy_)
+                .setCausality(causality_t::OUTPUT);
+        register_continuous_states("x", state_.x, dx_, 2);
+        register_state(&Model::state_);
+    }
+
+    void update_derivatives() override {
+        const auto &x = state_.x;
+        dx_[0] = x[1];
+        dx_[1] = -k_ * x[0];
+        energy_ = 0.5 * (k_ * x[0] * x[0] + x[1] * x[1]);
+        ++evaluations;
+    }
+
+    bool do_step(double dt) override {
+        update_derivatives();
+        for (int i = 0; i < 2; i++) {
+            state_.x[i] += dx_[i] * dt;
+        }
+        return true;
+    }
+
+    inline static int evaluations = 0;
+
+private:
+    double k_{4};
+    double energy_{0};
+    double dx_[2]{};
+
+    struct State {
+        double x[2]{1, 0};
+    } state_;
+};
+
+model_info fmu4cpp::get_model_info() {
+    model_info info;
+    info.modelName = "Oscillator";
+    return info;
+}
+
+std::string fmu4cpp::model_identifier() {
+    return "model_exchange";
+}
+
+FMU4CPP_INSTANTIATE(Model);
+
+void fmilogger(fmi3InstanceEnvironment, fmi3Status status, fmi3String /*category*/, fmi3String message) {
+    std::cerr << message << std::endl;
+}
+
+TEST_CASE("test_model_exchange") {
+
+    Model model({});
+    const auto guid = model.guid();
+
+    // time is 0, then k, energy, x[0..1] and der(x[0..1])
+    const fmi3ValueReference k{1}, energy{2};
+
+    const auto description = model.make_description();
+    std::cout << description << std::endl;
+    REQUIRE(description.find("<ModelExchange") != std::string::npos);
+    REQUIRE(description.find("name=\"der(x[1])\" valueReference=\"6\"") != std::string::npos);
+    REQUIRE(description.find("derivative=\"4\"") != std::string::npos);
+    REQUIRE(description.find("<ContinuousStateDerivative valueReference=\"5\"/>") != std::string::npos);
+
+    const auto c = fmi3InstantiateModelExchange("model_exchange", guid.c_str(), "", false, true, nullptr, fmilogger);
+    REQUIRE(c);
+
+    size_t nx;
+    REQUIRE(fmi3GetNumberOfContinuousStates(c, &nx) == fmi3OK);
+    REQUIRE(nx == 2);
+    size_t ni;
+    REQUIRE(fmi3GetNumberOfEventIndicators(c, &ni) == fmi3OK);
+    REQUIRE(ni == 0);
+
+    const double newK = 1;
+    REQUIRE(fmi3EnterInitializationMode(c, false, 0, 0, false, 0) == fmi3OK);
+    REQUIRE(fmi3SetFloat64(c, &k, 1, &newK, 1) == fmi3OK);
+    REQUIRE(fmi3ExitInitializationMode(c) == fmi3OK);
+
+    // Model Exchange starts in event mode
+    fmi3Boolean discreteStatesNeedUpdate, terminateSimulation, nominalsChanged, valuesChanged, nextEventTimeDefined;
+    fmi3Float64 nextEventTime;
+    REQUIRE(fmi3UpdateDiscreteStates(c, &discreteStatesNeedUpdate, &terminateSimulation, &nominalsChanged,
+                                     &valuesChanged, &nextEventTimeDefined, &nextEventTime) == fmi3OK);
+    REQUIRE_FALSE(discreteStatesNeedUpdate);
+    REQUIRE_FALSE(nextEventTimeDefined);
+    REQUIRE(fmi3EnterContinuousTimeMode(c) == fmi3OK);
+
+    double x[2], dx[2];
+    REQUIRE(fmi3GetContinuousStates(c, x, 2) == fmi3OK);
+    REQUIRE(x[0] == 1);
+    REQUIRE(x[1] == 0);
+
+    double nominals[2];
+    REQUIRE(fmi3GetNominalsOfContinuousStates(c, nominals, 2) == fmi3OK);
+    REQUIRE(nominals[1] == 1);
+
+    // forward Euler over a quarter period, with derivatives only evaluated when read
+    const double dt = 1e-4;
+    const auto steps = static_cast<int>(std::round(M_PI / 2 / dt));
+    double t = 0;
+    for (int i = 0; i < steps; i++) {
+        REQUIRE(fmi3GetContinuousStateDerivatives(c, dx, 2) == fmi3OK);
+        t += dt;
+        for (int j = 0; j < 2; j++) {
+            x[j] += dx[j] * dt;
+        }
+        REQUIRE(fmi3SetTime(c, t) == fmi3OK);
+        REQUIRE(fmi3SetContinuousStates(c, x, 2) == fmi3OK);
+
+        fmi3Boolean enterEventMode;
+        REQUIRE(fmi3CompletedIntegratorStep(c, true, &enterEventMode, &terminateSimulation) == fmi3OK);
+        REQUIRE_FALSE(enterEventMode);
+    }
+    CHECK(x[0] == Catch::Approx(0).margin(1e-3));
+    CHECK(x[1] == Catch::Approx(-1).margin(1e-3));
+
+    const auto evaluations = Model::evaluations;
+    double energyValue;
+    REQUIRE(fmi3GetFloat64(c, &energy, 1, &energyValue, 1) == fmi3OK);
+    REQUIRE(Model::evaluations == evaluations + 1);
+    CHECK(energyValue == Catch::Approx(0.5).epsilon(1e-3));
+
+    // outputs are up to date until something changes
+    REQUIRE(fmi3GetFloat64(c, &energy, 1, &energyValue, 1) == fmi3OK);
+    REQUIRE(fmi3GetContinuousStateDerivatives(c, dx, 2) == fmi3OK);
+    REQUIRE(Model::evaluations == evaluations + 1);
+    CHECK(dx[0] == x[1]);
+
+    REQUIRE(fmi3GetContinuousStates(c, x, 3) == fmi3Error);
+
+    fmi3FreeInstance(c);
+}
+
+TEST_CASE("test_model_exchange_not_for_co_simulation") {
+
+    Model model({});
+    const auto guid = model.guid();
+
+    const auto c = fmi3InstantiateCoSimulation("model_exchange", guid.c_str(), "", false, false, false, false, nullptr, 0, nullptr, fmilogger, nullptr);
+    REQUIRE(c);
+
+    size_t nx;
+    REQUIRE(fmi3GetNumberOfContinuousStates(c, &nx) == fmi3Error);
+
+    fmi3FreeInstance(c);
+}
+
+fmi3Instance instantiateModelExchange() {
+    Model model({});
+    const auto guid = model.guid();
+    const auto c = fmi3InstantiateModelExchange("model_exchange", guid.c_str(), "", false, true, nullptr, fmilogger);
+    REQUIRE(c);
+    return c;
+}
+
+TEST_CASE("test_model_exchange_states") {
+
+    double x[2]{1, 0};
+
+    // continuous-time functions need the model to be initialised
+    auto c = instantiateModelExchange();
+    REQUIRE(fmi3SetTime(c, 0) == fmi3Error);
+    fmi3FreeInstance(c);
+
+    // as does reading the states, derivatives and nominals
+    double dx[2], nominals[2];
+    c = instantiateModelExchange();
+    REQUIRE(fmi3GetContinuousStates(c, x, 2) == fmi3Error);
+    fmi3FreeInstance(c);
+    c = instantiateModelExchange();
+    REQUIRE(fmi3GetContinuousStateDerivatives(c, dx, 2) == fmi3Error);
+    fmi3FreeInstance(c);
+    c = instantiateModelExchange();
+    REQUIRE(fmi3GetNominalsOfContinuousStates(c, nominals, 2) == fmi3Error);
+    REQUIRE(fmi3EnterInitializationMode(c, false, 0, 0, false, 0) == fmi3Error);
+    fmi3FreeInstance(c);
+
+    c = instantiateModelExchange();
+    REQUIRE(fmi3EnterInitializationMode(c, false, 0, 0, false, 0) == fmi3OK);
+    REQUIRE(fmi3GetContinuousStates(c, x, 2) == fmi3OK);
+    REQUIRE(fmi3GetContinuousStateDerivatives(c, dx, 2) == fmi3OK);
+    REQUIRE(fmi3GetNominalsOfContinuousStates(c, nominals, 2) == fmi3OK);
+    fmi3FreeInstance(c);
+
+    c = instantiateModelExchange();
+    REQUIRE(fmi3EnterInitializationMode(c, false, 0, 0, false, 0) == fmi3OK);
+    REQUIRE(fmi3ExitInitializationMode(c) == fmi3OK);
+    REQUIRE(fmi3SetTime(c, 0) == fmi3OK);
+    REQUIRE(fmi3SetContinuousStates(c, x, 2) == fmi3Error);// not in event mode
+    fmi3FreeInstance(c);
+
+    // and there is no Co-Simulation step mode
+    c = instantiateModelExchange();
+    REQUIRE(fmi3EnterInitializationMode(c, false, 0, 0, false, 0) == fmi3OK);
+    REQUIRE(fmi3ExitInitializationMode(c) == fmi3OK);
+    REQUIRE(fmi3EnterStepMode(c) == fmi3Error);
+    fmi3FreeInstance(c);
+
+    c = instantiateModelExchange();
+    REQUIRE(fmi3EnterInitializationMode(c, false, 0, 0, false, 0) == fmi3OK);
+    REQUIRE(fmi3ExitInitializationMode(c) == fmi3OK);
+    REQUIRE(fmi3EnterContinuousTimeMode(c) == fmi3OK);
+    REQUIRE(fmi3SetContinuousStates(c, x, 2) == fmi3OK);
+    bool eventHandlingNeeded, terminateSimulation, earlyReturn;
+    double lastSuccessfulTime;
+    REQUIRE(fmi3DoStep(c, 0, 0.1, true, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime) == fmi3Error);
+    fmi3FreeInstance(c);
+}
+
+TEST_CASE("test_model_exchange_handles") {
+
+    Model model({});
+    model.enable_model_exchange();
+    model.enter_initialisation_mode(0, std::nullopt, std::nullopt);
+    model.finish_initialisation();
+
+    double dx[2];
+    model.get_derivatives(dx, 2);
+    CHECK(dx[1] == -4);
+
+    // writes through a handle are seen by the next evaluation, like those through set_real
+    auto k = model.handle<double>("k");
+    k.set(1);
+    model.get_derivatives(dx, 2);
+    CHECK(dx[1] == -1);
+}
+
+TEST_CASE("test_model_exchange_fmu_state") {
+
+    Model model({});
+    model.enable_model_exchange();
+    model.enter_initialisation_mode(0, std::nullopt, std::nullopt);
+    model.finish_initialisation();
+
+    void *state = model.getFMUState();
+    const double x[2]{2, 0};
+    model.set_continuous_states(x, 2);
+
+    const fmi3ValueReference energy{2};
+    double value;
+    model.get_real(&energy, 1, &value);
+    CHECK(value == 8);
+
+    // restoring a state is seen by the next evaluation, like setting the states
+    model.setFmuState(state);
+    model.get_real(&energy, 1, &value);
+    CHECK(value == 2);
+    double dx[2];
+    model.get_derivatives(dx, 2);
+    CHECK(dx[1] == -4);
+
+    model.freeFmuState(&state);
+}
@@ -0,0 +1,135 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <iostream>
+
+#include <fmu4cpp/fmu_base.hpp>
+
+#include "fmi3/fmi3Functions.h"
+
+using namespace fmu4cpp;
+
+class Model : public fmu_base {
+
+public:
+    FMU4CPP_CTOR(Model) {
+
+        register_float32("pixels", &pixels_[0]).setCausality(causality_t::INPUT);
+        register_float32("pixels2", &pixels_[1]).setCausality(causality_t::INPUT);
+        register_int8("offset", &offset_).setCausality(causality_t::PARAMETER).setVariability(variability_t::TUNABLE).setMin(-10).setMax(10);
+        register_uint8("flags", &flags_).setCausality(causality_t::OUTPUT);
+        register_int16("int16", &int16_).setCausality(causality_t::INPUT);
+        register_uint16("uint16", [this] { return uint16_; }, [this](uint16_t v) { uint16_ = v; }).setCausality(causality_t::INPUT);
+        register_uint32("uint32", &uint32_).setCausality(causality_t::INPUT);
+        register_int64("int64", &int64_).setCausality(causality_t::INPUT);
+        register_uint64("counter", [this] { return counter_; }).setCausality(causality_t::OUTPUT);
+    }
+
+    bool do_step(double dt) override {
+        flags_ = static_cast<uint8_t>(pixels_[0] > 0.5f) | static_cast<uint8_t>(offset_ > 0) << 1;
+        ++counter_;
+        return true;
+    }
+
+private:
+    float pixels_[2]{};
+    int8_t offset_{-3};
+    uint8_t flags_{0};
+    int16_t int16_{0};
+    uint16_t uint16_{0};
+    uint32_t uint32_{0};
+    int64_t int64_{0};
+    uint64_t counter_{0};
+};
+
+model_info fmu4cpp::get_model_info() {
+    model_info info;
+    info.modelName = "NumericTypes";
+    return info;
+}
+
+std::string fmu4cpp::model_identifier() {
+    return "numeric_types";
+}
+
+FMU4CPP_INSTANTIATE(Model);
+
+void fmilogger(fmi3InstanceEnvironment, fmi3Status status, fmi3String /*category*/, fmi3String message) {
+    std::cerr << message << std::endl;
+}
+
+TEST_CASE("test_numeric_types") {
+
+    Model model({});
+    const auto guid = model.guid();
+
+    const auto description = model.make_description();
+    REQUIRE(description.find("<Float32 name=\"pixels\"") != std::string::npos);
+    REQUIRE(description.find("<Int8 name=\"offset\"") != std::string::npos);
+    REQUIRE(description.find("start=\"-3\" min=\"-10\" max=\"10\"") != std::string::npos);
+    REQUIRE(description.find("<UInt8 name=\"flags\"") != std::string::npos);
+    REQUIRE(description.find("<Int16 name=\"int16\"") != std::string::npos);
+    REQUIRE(description.find("<UInt16 name=\"uint16\"") != std::string::npos);
+    REQUIRE(description.find("<UInt32 name=\"uint32\"") != std::string::npos);
+    REQUIRE(description.find("<Int64 name=\"int64\"") != std::string::npos);
+    REQUIRE(description.find("<UInt64 name=\"counter\"") != std::string::npos);
+
+    const auto c = fmi3InstantiateCoSimulation("numeric_types", guid.c_str(), "", false, true, false, false, nullptr, 0, nullptr, fmilogger, nullptr);
+    REQUIRE(c);
+
+    REQUIRE(fmi3EnterInitializationMode(c, false, 0, 0, false, 0) == fmi3OK);
+    REQUIRE(fmi3ExitInitializationMode(c) == fmi3OK);
+
+    // time is 0, then in order of registration
+    const fmi3ValueReference pixels[]{1, 2};
+    const fmi3ValueReference offset{3}, flags{4}, int16{5}, uint16{6}, uint32{7}, int64{8}, counter{9};
+
+    const fmi3Float32 pixelValues[]{0.75f, 0.25f};
+    REQUIRE(fmi3SetFloat32(c, pixels, 2, pixelValues, 2) == fmi3OK);
+    fmi3Float32 pixelsOut[2]{};
+    REQUIRE(fmi3GetFloat32(c, pixels, 2, pixelsOut, 2) == fmi3OK);
+    REQUIRE(pixelsOut[0] == 0.75f);
+    REQUIRE(pixelsOut[1] == 0.25f);
+
+    const fmi3Int8 offsetValue = 5;
+    REQUIRE(fmi3SetInt8(c, &offset, 1, &offsetValue, 1) == fmi3OK);
+
+    const fmi3Int16 int16Value = -1234;
+    REQUIRE(fmi3SetInt16(c, &int16, 1, &int16Value, 1) == fmi3OK);
+    const fmi3UInt16 uint16Value = 65000;
+    REQUIRE(fmi3SetUInt16(c, &uint16, 1, &uint16Value, 1) == fmi3OK);
+    const fmi3UInt32 uint32Value = 4000000000u;
+    REQUIRE(fmi3SetUInt32(c, &uint32, 1, &uint32Value, 1) == fmi3OK);
+    const fmi3Int64 int64Value = -(int64_t{1} << 40);
+    REQUIRE(fmi3SetInt64(c, &int64, 1, &int64Value, 1) == fmi3OK);
+
+    bool eventHandlingNeeded, terminateSimulation, earlyReturn;
+    double lastSuccessfulTime;
+    REQUIRE(fmi3DoStep(c, 0, 0.1, true, &eventHandlingNeeded, &terminateSimulation, &earlyReturn, &lastSuccessfulTime) == fmi3OK);
+
+    fmi3UInt8 flagsValue;
+    REQUIRE(fmi3GetUInt8(c, &flags, 1, &flagsValue, 1) == fmi3OK);
+    REQUIRE(flagsValue == 3);
+
+    fmi3UInt64 counterValue;
+    REQUIRE(fmi3GetUInt64(c, &counter, 1, &counterValue, 1) == fmi3OK);
+    REQUIRE(counterValue == 1);
+
+    fmi3Int16 int16Out;
+    REQUIRE(fmi3GetInt16(c, &int16, 1, &int16Out, 1) == fmi3OK);
+    REQUIRE(int16Out == int16Value);
+    fmi3UInt16 uint16Out;
+    REQUIRE(fmi3GetUInt16(c, &uint16, 1, &uint16Out, 1) == fmi3OK);
+    REQUIRE(uint16Out == uint16Value);
+    fmi3UInt32 uint32Out;
+    REQUIRE(fmi3GetUInt32(c, &uint32, 1, &uint32Out, 1) == fmi3OK);
+    REQUIRE(uint32Out == uint32Value);
+    fmi3Int64 int64Out;
+    REQUIRE(fmi3GetInt64(c, &int64, 1, &int64Out, 1) == fmi3OK);
+    REQUIRE(int64Out == int64Value);
+
+    // the type has to match
+    fmi3Int8 wrongType;
+    REQUIRE(fmi3GetInt8(c, &flags, 1, &wrongType, 1) == fmi3Error);
+
+    fmi3FreeInstance(c);
+}
@@ -0,0 +1,79 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <iostream>
+
+#include <fmu4cpp/fmu_base.hpp>
+#include <fmu4cpp/vendor_extensions.h>
+
+#include "Identity.hpp"
+#include "fmi3/fmi3Functions.h"
+
+
+std::string fmu4cpp::model_identifier() {
+    return "identity";
+}
+
+void fmilogger(fmi3InstanceEnvironment, fmi3Status status, fmi3String /*category*/, fmi3String message) {
+    std::cerr << message << std::endl;
+}
+
+TEST_CASE("test_prepared_access") {
+
+    Model model({});
+    const auto guid = model.guid();
+    REQUIRE(model.make_description().find("<Extension name=\"fmu4cppPrepareAccess\"/>") != std::string::npos);
+
+    const auto realIn = model.get_real_variable("realIn")->value_reference();
+    const auto realOut = model.get_real_variable("realOut")->value_reference();
+    const auto booleanIn = model.get_bool_variable("booleanIn")->value_reference();
+    const auto stringIn = model.get_string_variable("stringIn")->value_reference();
+
+    const auto c = fmi3InstantiateCoSimulation("identity", guid.c_str(), "", false, true, false, false, nullptr, 0, nullptr, fmilogger, nullptr);
+    REQUIRE(c);
+
+    REQUIRE(fmi3EnterInitializationMode(c, false, 0, 0, false, 0) == fmi3OK);
+    REQUIRE(fmi3ExitInitializationMode(c) == fmi3OK);
+
+    const auto in = fmu4cppPrepareAccess(c, &realIn, 1);
+    const auto out = fmu4cppPrepareAccess(c, &realOut, 1);
+    const auto b = fmu4cppPrepareAccess(c, &booleanIn, 1);
+    REQUIRE(in);
+    REQUIRE(out);
+    REQUIRE(b);
+
+    // strings are not supported
+    REQUIRE(fmu4cppPrepareAccess(c, &stringIn, 1) == nullptr);
+
+    double t{0};
+    const double dt{0.1};
+    while (t < 1) {
+        REQUIRE(fmu4cppSetRealPrepared(in, &t) == fmiOK);
+        const bool flag = t > 0.5;
+        REQUIRE(fmu4cppSetBooleanPrepared(b, &flag) == fmiOK);
+
+        bool eventhandlingNeeded;
+        bool terminateSimulation;
+        bool earlyReturn;
+        double lastSucessfulTime;
+        REQUIRE(fmi3DoStep(c, t, dt, true, &eventhandlingNeeded, &terminateSimulation, &earlyReturn, &lastSucessfulTime) == fmi3OK);
+
+        double value;
+        REQUIRE(fmu4cppGetRealPrepared(out, &value) == fmiOK);
+        REQUIRE(value == t);
+        bool flagOut;
+        REQUIRE(fmu4cppGetBooleanPrepared(b, &flagOut) == fmiOK);
+        REQUIRE(flagOut == flag);
+
+        t += dt;
+    }
+
+    // outputs cannot be set
+    REQUIRE(fmu4cppSetRealPrepared(out, &t) == fmiError);
+    int i;
+    REQUIRE(fmu4cppGetIntegerPrepared(in, &i) == fmiError);
+
+    fmu4cppFreeAccess(in);
+    fmu4cppFreeAccess(b);
+
+    fmi3FreeInstance(c);
+}
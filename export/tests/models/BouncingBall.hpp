@@ -17,32 +17,28 @@ class BouncingBall : public fmu_base {
 public:
     FMU4CPP_CTOR(BouncingBall) {
 
-        register_real(
-                "height", &state_.height_)
+        register_fields(&BouncingBall::state_);
+
+        real_variable("height")
                 .setCausality(causality_t::OUTPUT)
                 .setVariability(variability_t::CONTINUOUS)
                 .setInitial(initial_t::EXACT)
                 .setDescription("Current height of the ball");
 
-        register_real(
-                "velocity", &state_.velocity_)
+        real_variable("velocity")
                 .setCausality(causality_t::LOCAL)
                 .setVariability(variability_t::CONTINUOUS)
                 .setDescription("Current velocity of the ball");
 
-        register_real(
-                "gravity", &state_.gravity_)
+        real_variable("gravity")
                 .setCausality(causality_t::PARAMETER)
                 .setVariability(variability_t::FIXED)
                 .setDescription("Acceleration due to gravity");
 
-        register_real(
-                "bounceFactor", &state_.bounceFactor_)
+        real_variable("bounceFactor")
                 .setCausality(causality_t::PARAMETER)
                 .setVariability(variability_t::FIXED)
                 .setDescription("Factor to reduce velocity on bounce");
-
-        register_state(&BouncingBall::state_);
     }
 
     bool do_step(double dt) override {
@@ -73,6 +69,8 @@ private:
         double velocity_ = 0;      // Current velocity of the ball
         double gravity_ = -9.81;   // Acceleration due to gravity
         double bounceFactor_ = 0.6;// Factor to reduce velocity on bounce
+
+        FMU4CPP_REFLECT(State, height_, velocity_, gravity_, bounceFactor_)
     };
 
     State state_;
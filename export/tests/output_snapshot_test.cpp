@@ -0,0 +1,115 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <fmu4cpp/fmu_base.hpp>
+
+#include <atomic>
+#include <deque>
+#include <thread>
+
+class Model : public fmu4cpp::fmu_base {
+
+public:
+    FMU4CPP_CTOR(Model) {
+
+        register_integer("steps", &steps_)
+                .setCausality(fmu4cpp::causality_t::OUTPUT);
+        register_real("twice", &twice_)
+                .setCausality(fmu4cpp::causality_t::OUTPUT);
+        register_real("input", &input_)
+                .setCausality(fmu4cpp::causality_t::INPUT);
+        register_integer("stepsCopy", [this] { return steps_; })
+                .setCausality(fmu4cpp::causality_t::OUTPUT);
+    }
+
+    // registers variables after the snapshot has been set up, growing the variable vectors
+    void add_variables(size_t count) {
+        extra_.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            register_integer("extra[" + std::to_string(i) + "]", &extra_[i]);
+        }
+    }
+
+    bool do_step(double dt) override {
+        ++steps_;
+        twice_ = 2 * steps_;
+        return true;
+    }
+
+    void reset() override {}
+
+private:
+    int steps_{0};
+    double twice_{0};
+    double input_{0};
+    std::deque<int> extra_;
+};
+
+fmu4cpp::model_info fmu4cpp::get_model_info() {
+    return {};
+}
+
+std::string fmu4cpp::model_identifier() {
+    return "output_snapshot";
+}
+
+FMU4CPP_INSTANTIATE(Model);
+
+
+TEST_CASE("output snapshot") {
+
+    Model model({});
+
+    const unsigned int vrs[] = {1, 2};
+    double values[2];
+    CHECK_FALSE(model.read_output_snapshot(vrs, 2, values));
+
+    model.enable_output_snapshot();
+    double time;
+    REQUIRE(model.read_output_snapshot(vrs, 2, values, &time));
+    CHECK(values[0] == 0);
+    CHECK(values[1] == 0);
+    CHECK(time == 0);
+
+    // inputs are not part of the snapshot
+    const unsigned int input = 3;
+    CHECK_FALSE(model.read_output_snapshot(&input, 1, values));
+
+    constexpr int numSteps = 20000;
+    std::atomic<bool> done{false};
+    std::atomic<int> inconsistent{0};
+    std::thread reader([&] {
+        double v[2];
+        double t;
+        while (!done) {
+            model.read_output_snapshot(vrs, 2, v, &t);
+            if (v[1] != 2 * v[0] || t != v[0]) ++inconsistent;
+        }
+    });
+
+    for (int i = 0; i < numSteps; i++) {
+        REQUIRE(model.step(i, 1));
+    }
+    done = true;
+    reader.join();
+
+    CHECK(inconsistent == 0);
+    REQUIRE(model.read_output_snapshot(vrs, 2, values, &time));
+    CHECK(values[0] == numSteps);
+    CHECK(time == numSteps);
+}
+
+TEST_CASE("output snapshot after more registrations") {
+
+    Model model({});
+    model.enable_output_snapshot();
+    model.add_variables(100);
+
+    REQUIRE(model.step(0, 1));
+    REQUIRE(model.step(1, 1));
+
+    // the getter-backed output is still read from the right variable
+    const unsigned int stepsCopy = 4;
+    double value;
+    REQUIRE(model.read_output_snapshot(&stepsCopy, 1, &value));
+    CHECK(value == 2);
+}
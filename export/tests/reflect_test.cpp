@@ -0,0 +1,100 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <fmu4cpp/fmu_base.hpp>
+
+class Model : public fmu4cpp::fmu_base {
+
+public:
+    FMU4CPP_CTOR(Model) {
+
+        register_fields(&Model::state_, "pump.");
+
+        real_variable("pump.speed")
+                .setCausality(fmu4cpp::causality_t::INPUT);
+        int_variable("pump.count")
+                .setCausality(fmu4cpp::causality_t::OUTPUT);
+        bool_variable("pump.running")
+                .setCausality(fmu4cpp::causality_t::OUTPUT);
+    }
+
+    bool do_step(double dt) override {
+        state_.running_ = state_.speed_ > 0;
+        if (state_.running_) ++state_.count_;
+        return true;
+    }
+
+private:
+    struct State {
+        double speed_ = 1;
+        int count_ = 0;
+        bool running_ = false;
+
+        FMU4CPP_REFLECT(State, speed_, count_, running_)
+    };
+
+    State state_;
+};
+
+fmu4cpp::model_info fmu4cpp::get_model_info() {
+    return {};
+}
+
+std::string fmu4cpp::model_identifier() {
+    return "reflect";
+}
+
+FMU4CPP_INSTANTIATE(Model);
+
+
+TEST_CASE("register_fields") {
+
+    Model model({});
+
+    // time is vr 0, followed by the fields in order of declaration
+    const auto speed = model.find_real_variable("pump.speed");
+    const auto count = model.find_int_variable("pump.count");
+    const auto running = model.find_bool_variable("pump.running");
+    REQUIRE(speed);
+    REQUIRE(count);
+    REQUIRE(running);
+    CHECK(speed->value_reference() == 1);
+    CHECK(count->value_reference() == 2);
+    CHECK(running->value_reference() == 3);
+
+    CHECK(speed->causality() == fmu4cpp::causality_t::INPUT);
+    CHECK(count->causality() == fmu4cpp::causality_t::OUTPUT);
+    CHECK(running->causality() == fmu4cpp::causality_t::OUTPUT);
+
+    // the trailing underscore is dropped
+    CHECK_FALSE(model.find_real_variable("pump.speed_"));
+    CHECK_FALSE(model.find_real_variable("speed"));
+
+    // the variables point into the struct
+    const unsigned int speedVr = 1, countVr = 2, runningVr = 3;
+    const double newSpeed = 2;
+    model.set_real(&speedVr, 1, &newSpeed);
+    model.finish_initialisation();
+    REQUIRE(model.step(0, 0.1));
+
+    int countValue;
+    model.get_integer(&countVr, 1, &countValue);
+    CHECK(countValue == 1);
+    bool runningValue;
+    model.get_boolean(&runningVr, 1, &runningValue);
+    CHECK(runningValue);
+}
+
+TEST_CASE("field names") {
+
+    using fmu4cpp::reflect::field_names;
+
+    CHECK(field_names("a_, b,\n  c_") == std::vector<std::string>{"a", "b", "c"});
+    CHECK(field_names("_") == std::vector<std::string>{"_"});
+    CHECK(field_names("").empty());
+
+    // stray commas are rejected with a message instead of an out_of_range from deep within
+    CHECK_THROWS_AS(field_names("a, b,"), std::invalid_argument);
+    CHECK_THROWS_AS(field_names("a,, b"), std::invalid_argument);
+    CHECK_THROWS_AS(field_names(", a"), std::invalid_argument);
+    CHECK_THROWS_AS(field_names(" "), std::invalid_argument);
+}
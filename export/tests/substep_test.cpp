@@ -0,0 +1,129 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <fmu4cpp/fmu_base.hpp>
+
+#include <cmath>
+#include <vector>
+
+class Model : public fmu4cpp::substep_fmu_base {
+
+public:
+    Model(fmu4cpp::fmu_data data, double internalStep, internal_step kind)
+        : substep_fmu_base(std::move(data), internalStep, kind) {
+
+        register_real("x", &x_)
+                .setCausality(fmu4cpp::causality_t::OUTPUT);
+    }
+
+    bool do_substep(double h) override {
+        substeps_.push_back(h);
+        times_.push_back(currentTime());
+        x_ -= k_ * x_ * h;
+        return currentTime() < failAt_;
+    }
+
+    void reset() override {}
+
+    [[nodiscard]] double time() const {
+        return currentTime();
+    }
+
+    std::vector<double> substeps_;
+    std::vector<double> times_;
+    double failAt_{1e9};
+
+private:
+    double x_{1};
+    double k_{10};
+};
+
+fmu4cpp::model_info fmu4cpp::get_model_info() {
+    return {};
+}
+
+std::string fmu4cpp::model_identifier() {
+    return "substep";
+}
+
+std::unique_ptr<fmu4cpp::fmu_base> fmu4cpp::createInstance(const fmu_data &data) {
+    return std::make_unique<Model>(data, 1e-4, fmu4cpp::fmu_base::internal_step::FIXED);
+}
+
+using internal_step = fmu4cpp::fmu_base::internal_step;
+
+TEST_CASE("fixed internal step") {
+
+    Model model({}, 1e-4, internal_step::FIXED);
+    model.enter_initialisation_mode(0, std::nullopt, std::nullopt);
+    model.finish_initialisation();
+
+    // 10 ms communication steps with a 0.1 ms internal step
+    double t = 0;
+    const double dt = 0.01;
+    for (int i = 0; i < 100; i++) {
+        REQUIRE(model.step(t, dt));
+        t += dt;
+    }
+    CHECK(model.substeps_.size() == 100 * 100);
+    CHECK(model.times_[1] == 1e-4);
+    CHECK(model.times_.back() == 9999 * 1e-4);
+    // kept as start + ticks * h, instead of accumulating rounding errors over 10000 additions
+    CHECK(model.time() == 10000 * 1e-4);
+
+    double x;
+    const unsigned int vr = 1;
+    model.get_real(&vr, 1, &x);
+    CHECK(x == Catch::Approx(std::pow(1 - 10 * 1e-4, 10000)));
+
+    // communication steps have to be a multiple of the internal step
+    CHECK_THROWS(model.step(model.time(), 0.00015));
+}
+
+TEST_CASE("maximum internal step") {
+
+    Model model({}, 0.01, internal_step::MAXIMUM);
+    model.enter_initialisation_mode(1, std::nullopt, std::nullopt);
+    model.finish_initialisation();
+
+    REQUIRE(model.step(1, 0.025));
+    REQUIRE(model.substeps_.size() == 3);
+    CHECK(model.substeps_[0] == Catch::Approx(0.025 / 3));
+    CHECK(model.times_[2] == Catch::Approx(1 + 2 * 0.025 / 3));
+    CHECK(model.time() == 1.025);
+
+    // shorter communication steps are taken in one go
+    REQUIRE(model.step(1.025, 0.005));
+    CHECK(model.substeps_.size() == 4);
+    CHECK(model.substeps_.back() == 0.005);
+
+    // a failing sub-step fails the step, and time stays at the last successful sub-step
+    model.failAt_ = 1.045;
+    CHECK_FALSE(model.step(1.03, 0.03));
+    CHECK(model.time() == Catch::Approx(1.05));
+}
+
+TEST_CASE("early return between sub-steps") {
+
+    Model model({}, 0.1, internal_step::FIXED);
+    std::vector<double> updates;
+    model.set_intermediate_update([&](double time, bool canReturnEarly) -> std::optional<double> {
+        updates.push_back(time);
+        if (canReturnEarly) return 0.25;
+        return std::nullopt;
+    }, true);
+    model.enter_initialisation_mode(0, std::nullopt, std::nullopt);
+    model.finish_initialisation();
+
+    // the step ends at the first sub-step boundary at or after the requested time
+    REQUIRE(model.step(0, 1));
+    REQUIRE(model.early_return());
+    CHECK(*model.early_return() == Catch::Approx(0.3));
+    CHECK(model.time() == Catch::Approx(0.3));
+    CHECK(updates.size() == 3);
+
+    // and the ticks carry on from there
+    REQUIRE(model.step(model.time(), 0.1));
+    CHECK_FALSE(model.early_return());
+    CHECK(model.time() == Catch::Approx(0.4));
+}
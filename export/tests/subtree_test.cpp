@@ -0,0 +1,109 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <fmu4cpp/fmu_base.hpp>
+
+#include <numeric>
+#include <vector>
+
+using fmu4cpp::causality_t;
+
+class Model : public fmu4cpp::fmu_base {
+
+public:
+    FMU4CPP_CTOR(Model), pumps_(31) {
+
+        for (size_t i = 0; i < pumps_.size(); i++) {
+            const auto prefix = "pump[" + std::to_string(i) + "]";
+            auto &pump = pumps_[i];
+            register_real(prefix + ".motor.torque", &pump.torque).setCausality(causality_t::OUTPUT);
+            register_real(prefix + ".motor.speed", &pump.speed).setCausality(causality_t::OUTPUT);
+            register_real(prefix + ".flow", &pump.flow).setCausality(causality_t::OUTPUT);
+            register_boolean(prefix + ".running", &pump.running).setCausality(causality_t::OUTPUT);
+            register_real_range(prefix + ".pressure", pump.pressure, 4).setCausality(causality_t::OUTPUT);
+        }
+        register_integer("pumpCount", &pumpCount_).setCausality(causality_t::PARAMETER);
+    }
+
+    bool do_step(double dt) override {
+        return true;
+    }
+
+    void reset() override {}
+
+private:
+    struct pump {
+        double torque, speed, flow;
+        bool running;
+        double pressure[4];
+    };
+    std::vector<pump> pumps_;
+    int pumpCount_{31};
+};
+
+fmu4cpp::model_info fmu4cpp::get_model_info() {
+    return {};
+}
+
+std::string fmu4cpp::model_identifier() {
+    return "subtree";
+}
+
+FMU4CPP_INSTANTIATE(Model);
+
+using type = fmu4cpp::fmu_base::value_type;
+
+
+TEST_CASE("find subtree") {
+
+    Model model({});
+
+    // time is vr 0, then 8 per pump: torque, speed, flow, running and 4 pressures
+    const auto pump3 = model.find_subtree("pump[3]");
+    REQUIRE(pump3.size() == 3);
+    CHECK(pump3[0].type == type::REAL);
+    CHECK(pump3[0].first == 25);
+    CHECK(pump3[0].size == 3);
+    CHECK(pump3[1].type == type::BOOLEAN);
+    CHECK(pump3[1].first == 28);
+    CHECK(pump3[1].size == 1);
+    CHECK(pump3[2].type == type::REAL);
+    CHECK(pump3[2].first == 29);
+    CHECK(pump3[2].size == 4);
+
+    const auto motor = model.find_subtree("pump[3].motor");
+    REQUIRE(motor.size() == 1);
+    CHECK(motor[0].first == 25);
+    CHECK(motor[0].size == 2);
+
+    // a whole run can be read at once
+    std::vector<unsigned int> vrs(motor[0].size);
+    std::iota(vrs.begin(), vrs.end(), motor[0].first);
+    std::vector<double> values(vrs.size());
+    model.get_real(vrs.data(), vrs.size(), values.data());
+
+    // exact names, including range elements
+    const auto torque = model.find_subtree("pump[3].motor.torque");
+    REQUIRE(torque.size() == 1);
+    CHECK(torque[0].size == 1);
+    const auto pressure = model.find_subtree("pump[3].pressure[2]");
+    REQUIRE(pressure.size() == 1);
+    CHECK(pressure[0].first == 31);
+    CHECK(pressure[0].size == 1);
+
+    // pump[30] is not under pump[3], nor is anything under partial names
+    CHECK(model.find_subtree("pump[30]").size() == 3);
+    CHECK(model.find_subtree("pump[3").empty());
+    CHECK(model.find_subtree("pump[3].mot").empty());
+    CHECK(model.find_subtree("pump[3].pressure[4]").empty());
+    CHECK(model.find_subtree("unknown").empty());
+
+    // all pumps, where the pressures of one pump and the reals of the next form a single run,
+    // and not the parameter after them
+    const auto pumps = model.find_subtree("pump");
+    CHECK(pumps.size() == 1 + 2 * 31);
+    CHECK(pumps.back().first + pumps.back().size == 1 + 8 * 31);
+    const auto count = model.find_subtree("pumpCount");
+    REQUIRE(count.size() == 1);
+    CHECK(count[0].type == type::INTEGER);
+    CHECK(count[0].first == 1 + 8 * 31);
+}